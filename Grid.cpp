@@ -8,77 +8,40 @@ Grid::Grid(vec2 _TopLeft, vec2 _BottomRight, int _indentifier)
     this->indentifier = _indentifier;
 }
 
-bool Grid::IsInBounds(Tank& tank)
+void Grid::SetTankRange(size_t first, size_t blueCount, size_t redCount)
 {
-    vec2 TankPos = tank.position;
-    // check if tank position is in bounds
-    if (TankPos.x > this->TopLeft.x && TankPos.x < this->BottomRight.x && TankPos.y > this->TopLeft.y && TankPos.y < this->BottomRight.y)
-    {
-        return true;
-    }
-    return false;
+    this->firstTank = first;
+    this->teamCount[BLUE] = blueCount;
+    this->teamCount[RED] = redCount;
 }
 
-vector<Tank> Grid::GetTanksOutBounds()
+void Grid::UpdateFlags(const vector<Tank>& tanks, const vector<int>& gridTanks)
 {
-    hasRedTanks = false;
-    hasBlueTanks = false;
+    hasBlueTanks = teamCount[BLUE] > 0;
+    hasRedTanks = teamCount[RED] > 0;
     hasActiveTanks = false;
-    hasTanks = false;
-    // check if tank position is in bounds
-    vector<Tank> OutOfBoundsTanks;
-    vector<Tank> InBoundsTanks;
-    for (Tank& tank : this->tanks)
+    hasTanks = hasBlueTanks || hasRedTanks;
+
+    for (size_t i = firstTank; i < firstTank + GetTankCount(); i++)
     {
-        if (!IsInBounds(tank))
-        {
-            OutOfBoundsTanks.push_back(tank);
-        }
-        else
+        if(tanks[gridTanks[i]].active)
         {
-            InBoundsTanks.push_back(tank);
-            if(hasActiveTanks == false && tank.active)
-            {
-                hasActiveTanks = true;
-            }
-            if(tank.allignment == allignments::RED)
-            {
-                hasRedTanks = true;
-            } else
-            {
-                hasBlueTanks = true;
-            }
+            hasActiveTanks = true;
+            break;
         }
     }
-    
-    if(InBoundsTanks.size() > 0)
-    {
-        this->tanks = InBoundsTanks;
-        hasTanks = true;
-    } else
-    {
-        this->tanks.clear();
-        hasTanks = false;
-    }
-        
-    return OutOfBoundsTanks;
 }
 
-void Grid::AddTank(Tank& tank)
+TankRange Grid::GetTanks(vector<Tank>& tanks, const vector<int>& gridTanks) const
 {
-    this->tanks.push_back(tank);
-    hasTanks = true;
-    if(hasActiveTanks == false && tank.active)
-    {
-        hasActiveTanks = true;
-    }
-    if(tank.allignment == allignments::RED)
-    {
-        hasRedTanks = true;
-    } else
-    {
-        hasBlueTanks = true;
-    }
+    const int* first = gridTanks.data() + firstTank;
+    return TankRange(tanks, first, first + GetTankCount());
+}
+
+TankRange Grid::GetTeamTanks(allignments team, vector<Tank>& tanks, const vector<int>& gridTanks) const
+{
+    const int* first = gridTanks.data() + firstTank + ((team == BLUE) ? 0 : teamCount[BLUE]);
+    return TankRange(tanks, first, first + teamCount[team]);
 }
 
 int Grid::GetGridIndex(vec2 position, int gridSize, size_t gridWidth)
@@ -1,5 +1,35 @@
 ﻿#pragma once
 
+//Iterable view over the tanks of one grid, resolves the grids tank indices into the tanks vector
+class TankRange
+{
+public:
+    class Iterator
+    {
+    public:
+        Iterator(vector<Tank>* tanks, const int* index) : tanks(tanks), index(index) {}
+
+        Tank& operator*() const { return (*tanks)[*index]; }
+        Iterator& operator++() { ++index; return *this; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+
+    private:
+        vector<Tank>* tanks;
+        const int* index;
+    };
+
+    TankRange(vector<Tank>& tanks, const int* first, const int* last) : tanks(&tanks), first(first), last(last) {}
+
+    Iterator begin() const { return Iterator(tanks, first); }
+    Iterator end() const { return Iterator(tanks, last); }
+    size_t size() const { return last - first; }
+
+private:
+    vector<Tank>* tanks;
+    const int* first;
+    const int* last;
+};
+
 class Grid
 {
 public:
@@ -12,22 +42,35 @@ public:
     bool hasRedTanks = false;
     bool hasBlueTanks = false;
 
-    bool IsInBounds(Tank& tank);
-    vector<Tank> GetTanksOutBounds();
-
     vec2 GetTopLeft() { return this->TopLeft; }
     vec2 GetBottomRight() { return this->BottomRight; }
     vec2 GetCenter() { return vec2((this->TopLeft.x + this->BottomRight.x) / 2,
         (this->TopLeft.y + this->BottomRight.y) / 2); }
 
-    void AddTank(Tank& tank);
-    vector<Tank>& GetTanks() { return this->tanks; }
-    void ClearTanks() { this->tanks.clear(); }
+    //The tanks of a grid are stored as a range in the flat, grid sorted, tank index array
+    //The range is partitioned by team, blue tanks first
+    void SetTankRange(size_t first, size_t blueCount, size_t redCount);
+    void UpdateFlags(const vector<Tank>& tanks, const vector<int>& gridTanks);
+    TankRange GetTanks(vector<Tank>& tanks, const vector<int>& gridTanks) const;
+    TankRange GetTeamTanks(allignments team, vector<Tank>& tanks, const vector<int>& gridTanks) const;
+    size_t GetTankCount() const { return this->teamCount[BLUE] + this->teamCount[RED]; }
+    size_t GetTeamTankCount(allignments team) const { return this->teamCount[team]; }
+
+    //Team known at compile time, for the inner loops of the team queries
+    template <allignments team>
+    bool HasTeamTanks() const { return this->teamCount[team] > 0; }
+    template <allignments team>
+    TankRange GetTeamTanks(vector<Tank>& tanks, const vector<int>& gridTanks) const
+    {
+        const int* first = gridTanks.data() + this->firstTank + ((team == BLUE) ? 0 : this->teamCount[BLUE]);
+        return TankRange(tanks, first, first + this->teamCount[team]);
+    }
 
     static int GetGridIndex(vec2 position, int gridSize, size_t gridWidth);
 
 private:
-    vector<Tank> tanks = vector<Tank>();
+    size_t firstTank = 0;
+    size_t teamCount[2] = {0, 0};
     
     vec2 TopLeft;
     vec2 BottomRight;
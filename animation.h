@@ -0,0 +1,44 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//Sprite animations that only depend on time. An animated object keeps the frame it started on, the sprite frame
+//follows from the current game frame when drawing, so nothing has to be ticked to play an animation
+enum Animation_id
+{
+    SMOKE_ANIMATION,
+    EXPLOSION_ANIMATION,
+    PARTICLE_BEAM_ANIMATION,
+    TANK_TRACKS_ANIMATION,
+    ANIMATION_COUNT
+};
+
+struct Animation
+{
+    int frame_count;
+    //Game frames each sprite frame is shown
+    int frame_duration;
+    bool looping;
+
+    int get_duration() const { return frame_count * frame_duration; }
+
+    //Sprite frame on game frame, for an animation that started on start_frame. Animations that don't loop hold
+    //their last frame
+    int sprite_frame(long long start_frame, long long frame) const
+    {
+        const long long step = std::max(0ll, frame - start_frame) / frame_duration;
+        return (int)(looping ? step % frame_count : std::min<long long>(step, frame_count - 1));
+    }
+};
+
+constexpr Animation animations[ANIMATION_COUNT] = {
+    {4, 15, true}, //SMOKE_ANIMATION
+    {9, 1, false}, //EXPLOSION_ANIMATION
+    {3, 10, true}, //PARTICLE_BEAM_ANIMATION
+    {3, 3, true},  //TANK_TRACKS_ANIMATION
+};
+
+inline const Animation& get_animation(Animation_id id) { return animations[id]; }
+
+} // namespace Tmpl8
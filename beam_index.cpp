@@ -0,0 +1,86 @@
+#include "precomp.h"
+#include "beam_index.h"
+
+namespace Tmpl8
+{
+
+void Beam_index::build(const vector<Particle_beam>& beams, float reach, int grid_size, size_t grid_width, size_t grid_height)
+{
+    reach_bounds.clear();
+    covered_grids.clear();
+    covered_begin.assign(1, 0);
+
+    for (const Particle_beam& beam : beams)
+    {
+        const Rectangle2D bounds(beam.rectangle.min - vec2(reach, reach), beam.rectangle.max + vec2(reach, reach));
+        reach_bounds.push_back(bounds);
+
+        //All grids the grown rectangle overlaps, clipped to the map
+        const int first_x = std::max(0, (int)std::floor(bounds.min.x / grid_size));
+        const int first_y = std::max(0, (int)std::floor(bounds.min.y / grid_size));
+        const int last_x = std::min((int)grid_width - 1, (int)std::floor(bounds.max.x / grid_size));
+        const int last_y = std::min((int)grid_height - 1, (int)std::floor(bounds.max.y / grid_size));
+
+        for (int y = first_y; y <= last_y; y++)
+        {
+            for (int x = first_x; x <= last_x; x++)
+            {
+                covered_grids.push_back(y * (int)grid_width + x);
+            }
+        }
+        covered_begin.push_back(covered_grids.size());
+    }
+
+    beam_order.resize(beams.size());
+    std::iota(beam_order.begin(), beam_order.end(), 0);
+
+    nodes.clear();
+    if (!beams.empty())
+    {
+        nodes.emplace_back();
+        build_node(0, 0, (int)beams.size());
+    }
+}
+
+//Fills in the node for beam_order[first, first + count), splitting at the median of the longest axis
+void Beam_index::build_node(int node, int first, int count)
+{
+    Rectangle2D bounds = reach_bounds[beam_order[first]];
+    for (int i = first + 1; i < first + count; i++)
+    {
+        const Rectangle2D& b = reach_bounds[beam_order[i]];
+        bounds.min = vec2(std::min(bounds.min.x, b.min.x), std::min(bounds.min.y, b.min.y));
+        bounds.max = vec2(std::max(bounds.max.x, b.max.x), std::max(bounds.max.y, b.max.y));
+    }
+    nodes[node].bounds = bounds;
+
+    if (count <= leaf_capacity)
+    {
+        nodes[node].left = -1;
+        nodes[node].first = first;
+        nodes[node].count = count;
+        return;
+    }
+
+    const bool split_x = (bounds.max.x - bounds.min.x) >= (bounds.max.y - bounds.min.y);
+    auto center = [this, split_x](int beam)
+    {
+        const Rectangle2D& b = reach_bounds[beam];
+        return split_x ? b.min.x + b.max.x : b.min.y + b.max.y;
+    };
+
+    const int half = count / 2;
+    std::nth_element(beam_order.begin() + first, beam_order.begin() + first + half, beam_order.begin() + first + count, [&center](int a, int b) { return center(a) < center(b); });
+
+    //Children are stored next to each other
+    const int left = (int)nodes.size();
+    nodes[node].left = left;
+    nodes[node].first = first;
+    nodes[node].count = 0;
+    nodes.resize(nodes.size() + 2);
+
+    build_node(left, first, half);
+    build_node(left + 1, first + half, count - half);
+}
+
+} // namespace Tmpl8
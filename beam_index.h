@@ -0,0 +1,84 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//Lookup structure for static area effects like the particle beams
+//The grids each beam reaches are computed once when the index is built, so a beam walks its real grids without
+//searching for them. An AABB tree over the beams answers the other direction: which beams reach a given area
+//Rebuild when a beam is added or the grid size changes
+class Beam_index
+{
+  public:
+    //Reach is how far outside a beam's rectangle a tank center can be and still touch it (the largest tank radius)
+    void build(const vector<Particle_beam>& beams, float reach, int grid_size, size_t grid_width, size_t grid_height);
+
+    //Calls func(grid_index) for every grid the beam reaches
+    template <typename Func>
+    void for_each_covered_grid(size_t beam, Func func) const
+    {
+        for (size_t i = covered_begin[beam]; i < covered_begin[beam + 1]; i++) func((size_t)covered_grids[i]);
+    }
+
+    //Calls func(beam_index) for every beam that reaches the area
+    template <typename Func>
+    void query(const Rectangle2D& area, Func func) const;
+
+    size_t get_covered_grid_count() const { return covered_grids.size(); }
+
+  private:
+    struct Node
+    {
+        Rectangle2D bounds;
+
+        //Leaves hold beams[first, first + count), inner nodes their two children at left and left + 1
+        int left;
+        int first;
+        int count;
+    };
+
+    static constexpr int leaf_capacity = 4;
+
+    void build_node(int node, int first, int count);
+    static bool overlaps(const Rectangle2D& a, const Rectangle2D& b) { return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y; }
+
+    //Beam rectangles grown by the reach, indexed by beam
+    vector<Rectangle2D> reach_bounds;
+
+    vector<int> covered_grids;
+    vector<size_t> covered_begin;
+
+    vector<Node> nodes;
+    vector<int> beam_order;
+};
+
+template <typename Func>
+void Beam_index::query(const Rectangle2D& area, Func func) const
+{
+    if (nodes.empty()) return;
+
+    int stack[64];
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+
+    while (stack_size > 0)
+    {
+        const Node& node = nodes[stack[--stack_size]];
+        if (!overlaps(node.bounds, area)) continue;
+
+        if (node.count > 0)
+        {
+            for (int i = node.first; i < node.first + node.count; i++)
+            {
+                if (overlaps(reach_bounds[beam_order[i]], area)) func((size_t)beam_order[i]);
+            }
+        }
+        else
+        {
+            stack[stack_size++] = node.left;
+            stack[stack_size++] = node.left + 1;
+        }
+    }
+}
+
+} // namespace Tmpl8
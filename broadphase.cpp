@@ -0,0 +1,21 @@
+#include "precomp.h"
+#include "broadphase.h"
+
+namespace Tmpl8
+{
+
+std::unique_ptr<Broadphase> make_broadphase(Broadphase_type type, const vector<Grid>& grids, const vector<int>& grid_tanks, const Occupancy_bitmap& occupancy, vec2 world_size)
+{
+    switch (type)
+    {
+    case Broadphase_type::SORT_AND_SWEEP:
+        return std::make_unique<Sort_and_sweep_broadphase>();
+    case Broadphase_type::LOOSE_QUADTREE:
+        return std::make_unique<Loose_quadtree_broadphase>(world_size);
+    case Broadphase_type::UNIFORM_GRID:
+    default:
+        return std::make_unique<Uniform_grid_broadphase>(grids, grid_tanks, occupancy);
+    }
+}
+
+} // namespace Tmpl8
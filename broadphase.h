@@ -0,0 +1,51 @@
+#pragma once
+
+class Grid;
+
+namespace Tmpl8
+{
+
+enum class Broadphase_type
+{
+    UNIFORM_GRID,
+    SORT_AND_SWEEP,
+    LOOSE_QUADTREE
+};
+
+//Finds the tanks that overlap each other and pushes them apart
+//Every backend only writes the force of the tank it is handling, so collide can split the tanks over the threads
+class Broadphase
+{
+  public:
+    virtual ~Broadphase() {}
+
+    virtual const char* get_name() const = 0;
+
+    //Rebuild the structure from the tank positions of this frame
+    virtual void build(const vector<Tank>& tanks, ThreadPool& pool, size_t thread_count) = 0;
+
+    //Push every active tank away from all tanks it overlaps with
+    virtual void collide(vector<Tank>& tanks, ThreadPool& pool, size_t thread_count) = 0;
+
+  protected:
+    //Push t away from other if they overlap, returns if they did
+    static bool push_apart(Tank& t, const Tank& other)
+    {
+        vec2 dir = t.get_position() - other.get_position();
+
+        float col_squared_len = (t.get_collision_radius() + other.get_collision_radius());
+        col_squared_len *= col_squared_len;
+
+        if (dir.sqr_length() < col_squared_len)
+        {
+            t.push(dir.normalized(), 1.f);
+            return true;
+        }
+        return false;
+    }
+};
+
+//Creates the backend of the given type, the uniform grid reads the grids the game keeps up to date
+std::unique_ptr<Broadphase> make_broadphase(Broadphase_type type, const vector<Grid>& grids, const vector<int>& grid_tanks, const Occupancy_bitmap& occupancy, vec2 world_size);
+
+} // namespace Tmpl8
@@ -0,0 +1,53 @@
+#include "precomp.h"
+#include "cell_size_tuner.h"
+
+namespace Tmpl8
+{
+
+int Cell_size_tuner::pick(const vector<Tank>& tanks, int current_size)
+{
+    int best_size = current_size;
+    float best_cost = estimate_cost(tanks, current_size) * switch_threshold;
+
+    for (int size : candidate_sizes)
+    {
+        if ((float)size < interaction_distance || size == current_size) continue;
+
+        const float cost = estimate_cost(tanks, size);
+        if (cost < best_cost)
+        {
+            best_size = size;
+            best_cost = cost;
+        }
+    }
+
+    return best_size;
+}
+
+float Cell_size_tuner::estimate_cost(const vector<Tank>& tanks, int grid_size)
+{
+    const size_t grid_width = (size_t)std::ceil(world_size.x / grid_size);
+    const size_t grid_height = (size_t)std::ceil(world_size.y / grid_size);
+    const size_t grid_count = grid_width * grid_height;
+
+    counts.assign(grid_count, 0);
+
+    float cost = grid_cost * (float)grid_count;
+    for (const Tank& t : tanks)
+    {
+        if (t.active == false) continue;
+
+        const int index = Grid::GetGridIndex(t.position, grid_size, grid_width);
+        if (index < 0 || index >= (int)grid_count) continue;
+
+        //Going from n to n + 1 tanks adds 2n + 1 pair checks
+        int& count = counts[index];
+        cost += (float)(2 * count + 1);
+        if (count == 0) cost += occupied_grid_cost;
+        count++;
+    }
+
+    return cost;
+}
+
+} // namespace Tmpl8
@@ -0,0 +1,37 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//Picks the grid size for the tank positions of a frame, by estimating the cost of the grid passes for a few sizes:
+//the collision pass costs tanks^2 per grid, every occupied grid has a fixed overhead in all passes that visit
+//occupied grids, and every grid costs a little in the rebin and the distance field.
+//Grids never get smaller than the largest interaction distance (a rocket hitting a tank)
+class Cell_size_tuner
+{
+  public:
+    Cell_size_tuner(vec2 world_size, float interaction_distance) : world_size(world_size), interaction_distance(interaction_distance) {}
+
+    //Cheapest grid size for the tanks, current_size is kept unless another size is clearly cheaper
+    int pick(const vector<Tank>& tanks, int current_size);
+
+    //Estimated cost of a frame of grid passes in units of a single tank pair check
+    float estimate_cost(const vector<Tank>& tanks, int grid_size);
+
+  private:
+    static constexpr int candidate_sizes[] = {8, 12, 16, 20, 24, 32, 48, 64};
+
+    //Relative to a single tank pair check
+    static constexpr float occupied_grid_cost = 8.f;
+    static constexpr float grid_cost = 0.5f;
+
+    //A new size has to be this much cheaper than the current one, so it doesn't flip between two sizes
+    static constexpr float switch_threshold = 0.9f;
+
+    vec2 world_size;
+    float interaction_distance;
+
+    vector<int> counts;
+};
+
+} // namespace Tmpl8
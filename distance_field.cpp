@@ -0,0 +1,146 @@
+#include "precomp.h"
+#include "distance_field.h"
+
+namespace Tmpl8
+{
+
+void Distance_field::resize(size_t grid_width, size_t grid_height)
+{
+    this->grid_width = grid_width;
+    this->grid_height = grid_height;
+
+    for (int team = BLUE; team <= RED; team++)
+    {
+        column_nearest_row[team].assign(grid_width * grid_height, -1);
+        nearest_grid[team].assign(grid_width * grid_height, -1);
+    }
+}
+
+void Distance_field::build(const Occupancy_bitmap& occupancy, ThreadPool& pool, size_t thread_count)
+{
+    //Columns are independent of each other, and so are the rows once all columns are done
+    run_partitioned(pool, Grid_partitioner::split_evenly(grid_width, thread_count), [this, &occupancy](Grid_range columns)
+    {
+        build_columns(occupancy, BLUE, columns.begin, columns.end);
+        build_columns(occupancy, RED, columns.begin, columns.end);
+    });
+
+    run_partitioned(pool, Grid_partitioner::split_evenly(grid_height, thread_count), [this](Grid_range rows)
+    {
+        build_rows(BLUE, rows.begin, rows.end);
+        build_rows(RED, rows.begin, rows.end);
+    });
+}
+
+float Distance_field::grid_distance(allignments team, size_t grid_index) const
+{
+    const int nearest = nearest_grid[team][grid_index];
+    if (nearest < 0) return numeric_limits<float>::infinity();
+
+    const float dx = (float)(nearest % grid_width) - (float)(grid_index % grid_width);
+    const float dy = (float)(nearest / grid_width) - (float)(grid_index / grid_width);
+    return sqrtf(dx * dx + dy * dy);
+}
+
+//Closest occupied row in the same column, with a downward and an upward sweep
+void Distance_field::build_columns(const Occupancy_bitmap& occupancy, allignments team, size_t first_x, size_t last_x)
+{
+    vector<int>& rows = column_nearest_row[team];
+
+    for (size_t x = first_x; x < last_x; x++)
+    {
+        int last_occupied = -1;
+        for (size_t y = 0; y < grid_height; y++)
+        {
+            if (occupancy.test(team, y * grid_width + x)) last_occupied = (int)y;
+            rows[y * grid_width + x] = last_occupied;
+        }
+
+        int next_occupied = -1;
+        for (size_t y = grid_height; y-- > 0;)
+        {
+            if (occupancy.test(team, y * grid_width + x)) next_occupied = (int)y;
+
+            int& nearest = rows[y * grid_width + x];
+            if (next_occupied >= 0 && (nearest < 0 || (next_occupied - (int)y) < ((int)y - nearest)))
+            {
+                nearest = next_occupied;
+            }
+        }
+    }
+}
+
+//Per row, the lower envelope of the parabolas (x - column)^2 + column_distance^2 of all columns
+//that have an occupied grid. The parabola on top of the envelope at x is the closest grid for x
+void Distance_field::build_rows(allignments team, size_t first_y, size_t last_y)
+{
+    const vector<int>& rows = column_nearest_row[team];
+    vector<int>& nearest = nearest_grid[team];
+
+    vector<int> parabolas(grid_width);
+    vector<float> boundaries(grid_width + 1);
+
+    for (size_t y = first_y; y < last_y; y++)
+    {
+        const size_t row_start = y * grid_width;
+
+        auto height = [&rows, row_start, y](int x)
+        {
+            const float dy = (float)(rows[row_start + x] - (int)y);
+            return dy * dy;
+        };
+
+        //Build the lower envelope from left to right
+        int count = 0;
+        for (int x = 0; x < (int)grid_width; x++)
+        {
+            if (rows[row_start + x] < 0) continue;
+
+            if (count == 0)
+            {
+                parabolas[0] = x;
+                boundaries[0] = -numeric_limits<float>::infinity();
+                boundaries[1] = numeric_limits<float>::infinity();
+                count = 1;
+                continue;
+            }
+
+            float intersection;
+            while (true)
+            {
+                const int top = parabolas[count - 1];
+                intersection = ((height(x) + x * x) - (height(top) + top * top)) / (2.f * (x - top));
+                if (count > 1 && intersection <= boundaries[count - 1])
+                {
+                    count--;
+                    continue;
+                }
+                break;
+            }
+
+            parabolas[count] = x;
+            boundaries[count] = intersection;
+            boundaries[count + 1] = numeric_limits<float>::infinity();
+            count++;
+        }
+
+        if (count == 0)
+        {
+            //No tanks of this team in any column
+            std::fill(nearest.begin() + row_start, nearest.begin() + row_start + grid_width, -1);
+            continue;
+        }
+
+        //Read the closest column for every x from the envelope
+        int k = 0;
+        for (int x = 0; x < (int)grid_width; x++)
+        {
+            while (boundaries[k + 1] < (float)x) k++;
+
+            const int column = parabolas[k];
+            nearest[row_start + x] = rows[row_start + column] * (int)grid_width + column;
+        }
+    }
+}
+
+} // namespace Tmpl8
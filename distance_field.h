@@ -0,0 +1,36 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//For every grid, the closest grid (by center distance) holding tanks of a team
+//Rebuilt once per frame from the occupancy bitmaps, so a targeting query is a single lookup
+//Exact separable transform: first every column, then every row, so both passes split over the threads
+class Distance_field
+{
+  public:
+    void resize(size_t grid_width, size_t grid_height);
+    void build(const Occupancy_bitmap& occupancy, ThreadPool& pool, size_t thread_count);
+
+    //Closest grid to grid_index with tanks of the team, -1 if the team has no tanks on the map
+    int nearest(allignments team, size_t grid_index) const { return nearest_grid[team][grid_index]; }
+
+    //Distance in grids from grid_index to the closest grid with tanks of the team, infinity if there is none
+    float grid_distance(allignments team, size_t grid_index) const;
+
+    size_t get_width() const { return grid_width; }
+    size_t get_height() const { return grid_height; }
+
+  private:
+    void build_columns(const Occupancy_bitmap& occupancy, allignments team, size_t first_x, size_t last_x);
+    void build_rows(allignments team, size_t first_y, size_t last_y);
+
+    size_t grid_width = 0;
+    size_t grid_height = 0;
+
+    //Per grid: the row of the closest grid with tanks in the same column, -1 if the column is empty
+    vector<int> column_nearest_row[2];
+    vector<int> nearest_grid[2];
+};
+
+} // namespace Tmpl8
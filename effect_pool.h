@@ -0,0 +1,102 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//What an effect pool does with a new effect when all its slots are taken
+enum class Pool_full_policy
+{
+    DROP_NEW,       //The running effects keep playing, the new one is not shown
+    REPLACE_OLDEST  //The oldest effect is removed to make room
+};
+
+//Fixed capacity storage for short lived effects like explosions and smoke
+//Every effect in a pool lives equally long, so effects expire in the order they were spawned and the free slots
+//are always the part of the ring buffer after the newest effect. Spawning reuses those slots, no allocations after
+//the pool filled up once, and the memory and per frame cost stay bounded by the capacity
+template <typename Effect>
+class Effect_pool
+{
+  public:
+    //Lifetime in ticks, 0 keeps effects until the full policy replaces them
+    void configure(size_t capacity, int lifetime, Pool_full_policy policy)
+    {
+        this->capacity = std::max<size_t>(1, capacity);
+        this->lifetime = lifetime;
+        this->policy = policy;
+
+        slots.clear();
+        slots.reserve(this->capacity);
+        oldest = 0;
+        count = 0;
+    }
+
+    void spawn(const Effect& effect)
+    {
+        if (count == capacity)
+        {
+            dropped_count++;
+            if (policy == Pool_full_policy::DROP_NEW) return;
+
+            oldest = (oldest + 1) % capacity;
+            count--;
+        }
+
+        const size_t index = (oldest + count) % capacity;
+        if (index == slots.size())
+        {
+            slots.push_back({effect, current_tick});
+        }
+        else
+        {
+            slots[index] = {effect, current_tick};
+        }
+        count++;
+    }
+
+    //Advance a tick and free the effects that reached their lifetime, the effects themselves have nothing to update
+    void tick()
+    {
+        current_tick++;
+
+        while (lifetime > 0 && count > 0 && current_tick - slots[oldest].spawn_tick >= lifetime)
+        {
+            oldest = (oldest + 1) % capacity;
+            count--;
+        }
+    }
+
+    //Calls func(effect) for all live effects, oldest first
+    template <typename Func>
+    void for_each(Func func) const
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            func(slots[(oldest + i) % capacity].effect);
+        }
+    }
+
+    size_t size() const { return count; }
+
+    //Effects that were dropped or replaced because the pool was full
+    size_t get_dropped_count() const { return dropped_count; }
+
+  private:
+    struct Slot
+    {
+        Effect effect;
+        long long spawn_tick;
+    };
+
+    vector<Slot> slots;
+    size_t capacity = 1;
+    int lifetime = 0;
+    Pool_full_policy policy = Pool_full_policy::DROP_NEW;
+
+    size_t oldest = 0;
+    size_t count = 0;
+    long long current_tick = 0;
+    size_t dropped_count = 0;
+};
+
+} // namespace Tmpl8
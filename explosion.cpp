@@ -1,18 +1,7 @@
 #include "precomp.h"
 #include "explosion.h"
 
-bool Tmpl8::Explosion::done() const
+void Tmpl8::Explosion::draw(Render_buffer& buffer, long long frame) const
 {
-    return current_frame > 17;
-}
-
-void Tmpl8::Explosion::tick()
-{
-    if (current_frame < 18) current_frame++;
-}
-
-void Tmpl8::Explosion::draw(Surface* screen)
-{
-    explosion_sprite->set_frame(current_frame / 2);
-    explosion_sprite->draw(screen, (int)position.x + HEALTHBAR_OFFSET, (int)position.y);
+    buffer.push(EXPLOSION_LAYER, explosion_sprite, get_animation(EXPLOSION_ANIMATION).sprite_frame(start_frame, frame), (int)position.x + HEALTHBAR_OFFSET, (int)position.y);
 }
@@ -6,16 +6,14 @@ namespace Tmpl8
 class Explosion
 {
   public:
-    Explosion(Sprite* explosion_sprite, vec2 position) : current_frame(0), explosion_sprite(explosion_sprite), position(position) {}
+    Explosion(Sprite* explosion_sprite, vec2 position, long long start_frame) : start_frame(start_frame), explosion_sprite(explosion_sprite), position(position) {}
 
-    bool done() const;
-    void tick();
-    void draw(Surface* screen);
+    void draw(Render_buffer& buffer, long long frame) const;
 
     vec2 position;
 
-    int current_frame;
-    Sprite* explosion_sprite;
+    long long start_frame;
+    const Sprite* explosion_sprite;
 };
 
 }
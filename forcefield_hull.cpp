@@ -0,0 +1,183 @@
+#include "precomp.h"
+#include "forcefield_hull.h"
+
+namespace Tmpl8
+{
+
+void Forcefield_hull::update(vector<Tank>& tanks, const vector<int>& tank_slots, const vector<int>& tank_handles, const vector<Grid>& grids, const vector<int>& grid_tanks, const Occupancy_bitmap& occupancy, int grid_size, size_t grid_width, size_t grid_height)
+{
+    //Inner hull from the tanks of the last hull, as long as all of them are still in play
+    candidates.clear();
+    for (int handle : vertex_handles)
+    {
+        const Tank& t = tanks[tank_slots[handle]];
+        const int grid_index = Grid::GetGridIndex(t.position, grid_size, grid_width);
+        if (t.active == false || grid_index < 0 || grid_index >= (int)grids.size())
+        {
+            candidates.clear();
+            break;
+        }
+        candidates.push_back({t.position, tank_slots[handle]});
+    }
+
+    //Without a usable old hull, start from the tanks in the outermost grids of every row instead
+    if (candidates.empty())
+    {
+        add_row_extremes(tanks, grids, grid_tanks, occupancy, grid_width, grid_height);
+    }
+
+    inner_hull.clear();
+    if (candidates.size() >= 3)
+    {
+        build_hull(candidates, inner_hull);
+    }
+
+    candidates = inner_hull;
+    add_edge_tanks(tanks, grids, grid_tanks, occupancy, grid_size, grid_width, grid_height);
+    build_hull(candidates, hull_points);
+
+    hull.clear();
+    vertex_handles.clear();
+    for (const Hull_point& point : hull_points)
+    {
+        hull.push_back(point.position);
+        vertex_handles.push_back(tank_handles[point.tank]);
+    }
+}
+
+void Forcefield_hull::build_hull(vector<Hull_point>& points, vector<Hull_point>& result)
+{
+    result.clear();
+
+    std::sort(points.begin(), points.end(), [](const Hull_point& a, const Hull_point& b) { return (a.position.x < b.position.x) || (a.position.x == b.position.x && a.position.y < b.position.y); });
+    if (points.size() < 3)
+    {
+        result = points;
+        return;
+    }
+
+    auto cross = [](vec2 o, vec2 a, vec2 b) { return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x); };
+
+    result.resize(points.size() * 2);
+    size_t count = 0;
+
+    //Lower hull
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        while (count >= 2 && cross(result[count - 2].position, result[count - 1].position, points[i].position) <= 0) count--;
+        result[count++] = points[i];
+    }
+
+    //Upper hull
+    const size_t lower_count = count + 1;
+    for (size_t i = points.size() - 1; i-- > 0;)
+    {
+        while (count >= lower_count && cross(result[count - 2].position, result[count - 1].position, points[i].position) <= 0) count--;
+        result[count++] = points[i];
+    }
+
+    //The first point is repeated at the end
+    result.resize(count - 1);
+}
+
+void Forcefield_hull::add_row_extremes(vector<Tank>& tanks, const vector<Grid>& grids, const vector<int>& grid_tanks, const Occupancy_bitmap& occupancy, size_t grid_width, size_t grid_height)
+{
+    auto add_grid = [this, &tanks, &grids, &grid_tanks](size_t i)
+    {
+        for (Tank& t : grids[i].GetTanks(tanks, grid_tanks))
+        {
+            if (t.active) candidates.push_back({t.position, (int)(&t - tanks.data())});
+        }
+    };
+
+    size_t first_row = grid_height;
+    size_t last_row = 0;
+    for (size_t y = 0; y < grid_height; y++)
+    {
+        const size_t row_start = y * grid_width;
+
+        size_t first = row_start + grid_width;
+        size_t last = row_start;
+        occupancy.for_each_occupied(row_start, row_start + grid_width, [&first, &last](size_t i)
+        {
+            first = std::min(first, i);
+            last = i;
+        });
+        if (first > last) continue;
+
+        first_row = std::min(first_row, y);
+        last_row = y;
+
+        add_grid(first);
+        if (last != first) add_grid(last);
+    }
+
+    //The top and bottom row can have hull tanks anywhere along the row
+    if (first_row >= grid_height) return;
+    occupancy.for_each_occupied(first_row * grid_width, (first_row + 1) * grid_width, add_grid);
+    if (last_row != first_row) occupancy.for_each_occupied(last_row * grid_width, (last_row + 1) * grid_width, add_grid);
+}
+
+void Forcefield_hull::add_edge_tanks(vector<Tank>& tanks, const vector<Grid>& grids, const vector<int>& grid_tanks, const Occupancy_bitmap& occupancy, int grid_size, size_t grid_width, size_t grid_height)
+{
+    for (size_t y = 0; y < grid_height; y++)
+    {
+        const size_t row_start = y * grid_width;
+
+        //Grids [first_inside, last_inside) of this row are covered by the inner hull
+        size_t first_inside = 0;
+        size_t last_inside = 0;
+        float min_x, max_x;
+        if (inner_span((float)(y * grid_size), (float)((y + 1) * grid_size), min_x, max_x))
+        {
+            first_inside = (size_t)std::max(0.f, std::ceil(min_x / grid_size));
+            last_inside = (size_t)std::max(0.f, std::floor(max_x / grid_size));
+            last_inside = std::min(last_inside, grid_width);
+            if (last_inside < first_inside) last_inside = first_inside;
+        }
+
+        auto add_grid = [this, &tanks, &grids, &grid_tanks](size_t i)
+        {
+            for (Tank& t : grids[i].GetTanks(tanks, grid_tanks))
+            {
+                if (t.active) candidates.push_back({t.position, (int)(&t - tanks.data())});
+            }
+        };
+        occupancy.for_each_occupied(row_start, row_start + first_inside, add_grid);
+        occupancy.for_each_occupied(row_start + last_inside, row_start + grid_width, add_grid);
+    }
+}
+
+bool Forcefield_hull::inner_span(float y0, float y1, float& min_x, float& max_x) const
+{
+    if (inner_hull.size() < 3) return false;
+
+    //The covered x range of a convex polygon shrinks towards its top and bottom, so the range on the whole band is
+    //the overlap of the ranges on its top and bottom line
+    float span_min[2] = {numeric_limits<float>::infinity(), numeric_limits<float>::infinity()};
+    float span_max[2] = {-numeric_limits<float>::infinity(), -numeric_limits<float>::infinity()};
+    const float lines[2] = {y0, y1};
+
+    for (size_t i = 0; i < inner_hull.size(); i++)
+    {
+        const vec2 a = inner_hull[i].position;
+        const vec2 b = inner_hull[(i + 1) % inner_hull.size()].position;
+
+        for (int l = 0; l < 2; l++)
+        {
+            const float y = lines[l];
+            if ((y < a.y && y < b.y) || (y > a.y && y > b.y)) continue;
+
+            const float x = (a.y == b.y) ? a.x : a.x + (b.x - a.x) * (y - a.y) / (b.y - a.y);
+            const float x_other = (a.y == b.y) ? b.x : x;
+            span_min[l] = std::min({span_min[l], x, x_other});
+            span_max[l] = std::max({span_max[l], x, x_other});
+        }
+    }
+
+    min_x = std::max(span_min[0], span_min[1]);
+    max_x = std::min(span_max[0], span_max[1]);
+    return min_x <= max_x;
+}
+
+} // namespace Tmpl8
@@ -0,0 +1,51 @@
+#pragma once
+
+class Grid;
+
+namespace Tmpl8
+{
+
+//Convex hull around the active tanks on the map, kept up to date from frame to frame
+//The tanks on last frame's hull are still on the map, so the hull around their new positions lies inside the new
+//hull: every grid it fully covers can't hold a hull vertex and is skipped. Only the tanks in the grids along the
+//edge go into the hull algorithm, so the cost follows how much the hull changed instead of the number of tanks
+//When a tank of the old hull was destroyed or left the map, the inner hull is made from the tanks in the leftmost and
+//rightmost grid of every row and all grids of the top and bottom row instead, which skips the same way
+class Forcefield_hull
+{
+  public:
+    //Rebuild the hull for the tank positions of this frame. Tanks are remembered by handle, tank_slots maps a handle
+    //to its index in tanks and tank_handles the other way around
+    void update(vector<Tank>& tanks, const vector<int>& tank_slots, const vector<int>& tank_handles, const vector<Grid>& grids, const vector<int>& grid_tanks, const Occupancy_bitmap& occupancy, int grid_size, size_t grid_width, size_t grid_height);
+
+    const vector<vec2>& get_points() const { return hull; }
+
+  private:
+    struct Hull_point
+    {
+        vec2 position;
+        int tank;
+    };
+
+    //Andrew's monotone chain, counter clockwise without collinear points. Sorts points
+    static void build_hull(vector<Hull_point>& points, vector<Hull_point>& result);
+
+    //Add the tanks of the outermost occupied grids of every row, and of all grids of the outer rows, to candidates
+    void add_row_extremes(vector<Tank>& tanks, const vector<Grid>& grids, const vector<int>& grid_tanks, const Occupancy_bitmap& occupancy, size_t grid_width, size_t grid_height);
+
+    //Add the tanks of all grids that aren't fully inside the inner hull to candidates
+    void add_edge_tanks(vector<Tank>& tanks, const vector<Grid>& grids, const vector<int>& grid_tanks, const Occupancy_bitmap& occupancy, int grid_size, size_t grid_width, size_t grid_height);
+
+    //The x range the inner hull covers on the whole band between y0 and y1, false if it covers none
+    bool inner_span(float y0, float y1, float& min_x, float& max_x) const;
+
+    vector<Hull_point> inner_hull;
+    vector<Hull_point> candidates;
+    vector<Hull_point> hull_points;
+
+    //Handles of the tanks on the hull of the last frame
+    vector<int> vertex_handles;
+    vector<vec2> hull;
+};
+
+} // namespace Tmpl8
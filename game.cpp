@@ -9,6 +9,46 @@ constexpr auto particle_beam_hit_value = 50;
 
 constexpr auto tank_max_speed = 1.0;
 
+constexpr auto rocket_reload_frames = 200;
+//Pixels per frame, rocket hits are swept over the whole path so faster rockets don't pass through tanks
+constexpr auto rocket_speed = 3.f;
+//Frames a rocket flies before it is removed (0 for no limit), rockets that left the map are removed right away
+constexpr auto rocket_lifetime_frames = 600;
+//Only check rockets for hits once they could have reached an enemy tank, instead of every frame
+constexpr auto rocket_event_queue = true;
+
+//Tank level of detail, distances in pixels to the closest enemy grid
+constexpr auto lod_enabled = true;
+constexpr auto lod_near_distance = 192.f;
+constexpr auto lod_far_distance = 384.f;
+constexpr auto lod_mid_interval = 2;
+constexpr auto lod_far_interval = 4;
+
+//Grid size in pixels, independent of the terrain tiles. With auto tuning the grid size is picked from the tank
+//positions after spawning and checked again every grid_retune_interval frames (0 only tunes once)
+constexpr auto default_grid_size = 16;
+constexpr auto auto_tune_grid_size = true;
+constexpr auto grid_retune_interval = 250;
+
+//Tank collision backend, see broadphase.h
+constexpr auto broadphase_backend = Broadphase_type::UNIFORM_GRID;
+//Frames between running the collision pass of every backend on a copy of the tanks, 0 disables the benchmark
+constexpr auto broadphase_benchmark_interval = 0;
+
+//Frames between reordering the tank storage along the Z-curve, 0 keeps the spawn order
+constexpr auto morton_reorder_interval = 64;
+//Frames between running the collision pass and the tank blits on a copy of the tanks in spawn order and in Z-curve
+//order, 0 disables the benchmark
+constexpr auto morton_benchmark_interval = 0;
+
+//Effect pools, lifetimes in frames. A lifetime of 0 keeps effects until the pool is full
+constexpr auto explosion_capacity = 1024;
+constexpr auto explosion_lifetime = 9;
+constexpr auto explosion_full_policy = Pool_full_policy::DROP_NEW;
+constexpr auto smoke_capacity = 1024;
+constexpr auto smoke_lifetime = 1800;
+constexpr auto smoke_full_policy = Pool_full_policy::REPLACE_OLDEST;
+
 constexpr auto health_bar_width = 70;
 
 constexpr auto max_frames = 2000;
@@ -18,6 +58,12 @@ constexpr auto REF_PERFORMANCE = 40000; //2300000 for pc // 166965 for laptop on
 static timer perf_timer;
 static float duration;
 
+//Time spent in the passes that walk the tanks grid by grid, printed together with the duration
+//The tank queue pass only fills the render buffer, the blits of all sprites are timed by the sprite submit
+static float collision_pass_duration = 0.f;
+static float tank_queue_pass_duration = 0.f;
+static float sprite_submit_duration = 0.f;
+
 //Load sprite files and initialize sprites
 static Surface* tank_red_img = new Surface("assets/Tank_Proj2.png");
 static Surface* tank_blue_img = new Surface("assets/Tank_Blue_Proj2.png");
@@ -74,21 +120,42 @@ void Game::init()
     //////////////
     //Create Grid of tanks
     //////////////
-    const size_t gridWidth = background_terrain.GetWidth();
-    const size_t gridHeight = background_terrain.GetHeight();
-    
-    const size_t gridsCount = gridWidth * gridHeight;
-    grids = vector<Grid>(gridsCount);
-    
-    for (size_t i = 0; i < gridsCount - 1; i++)
+    rockets.set_collision_radius(rocket_radius);
+    rockets.set_sprite(BLUE, &rocket_blue);
+    rockets.set_sprite(RED, &rocket_red);
+
+    explosions.configure(explosion_capacity, explosion_lifetime, explosion_full_policy);
+    smokes.configure(smoke_capacity, smoke_lifetime, smoke_full_policy);
+
+    //Tanks move at most max speed * 0.5 per frame along their direction and pushes are capped (see Tank::tick)
+    //Tanks on a reduced tick rate make up the frames they skipped in one tick
+    const float tank_step = (float)tank_max_speed * 0.5f * (1.f + Tank::max_push_speed);
+    rocket_scheduler.set_limits(tank_step, tank_step * lod_far_interval);
+
+    world_size = background_terrain.GetWorldSize();
+    resize_grids(default_grid_size);
+
+    Lod_settings lod_settings;
+    lod_settings.enabled = lod_enabled;
+    lod_settings.near_distance = lod_near_distance;
+    lod_settings.far_distance = lod_far_distance;
+    lod_settings.mid_interval = lod_mid_interval;
+    lod_settings.far_interval = lod_far_interval;
+    lod.set_settings(lod_settings);
+
+    broadphase = make_broadphase(broadphase_backend, grids, grid_tanks, occupancy, world_size);
+    if (broadphase_benchmark_interval > 0)
     {
-        vec2 position{(float)(i % gridWidth) * gridSize, (float)(i / gridWidth) * gridSize };
-        grids[i] = Grid(position, position + vec2(gridSize, gridSize), i);
+        for (Broadphase_type type : {Broadphase_type::UNIFORM_GRID, Broadphase_type::SORT_AND_SWEEP, Broadphase_type::LOOSE_QUADTREE})
+        {
+            benchmark_broadphases.push_back(make_broadphase(type, grids, grid_tanks, occupancy, world_size));
+        }
     }
 
+    cell_size_tuner = std::make_unique<Cell_size_tuner>(world_size, tank_radius + rocket_radius);
+
     // lock update until all async init tasks are completed
     lock_update = true;
-    size_t gridIndexBound = grids.size();
 
     int numToSpawn = num_tanks_blue / thread_count;
 
@@ -96,11 +163,10 @@ void Game::init()
     int redCounter = 0;
 
     auto spawnbluetanks =
-        [start_blue_x, max_rows, spacing, start_blue_y, gridIndexBound, numToSpawn, blueCounter, this]
-    () -> std::tuple<vector<Tank>, vector<int>>
+        [start_blue_x, max_rows, spacing, start_blue_y, numToSpawn, blueCounter, this]
+    () -> vector<Tank>
     {
         vector<Tank> _tanks;
-        vector<int> _gridIndexes;
 
         std::unique_lock<std::mutex> locker(blues_mutex);
         for (int i = 0; i < numToSpawn; i++)
@@ -110,26 +176,15 @@ void Game::init()
 
             _tanks.push_back(Tank(position.x, position.y, BLUE, &tank_blue, &smoke,
                 1100.f, position.y + 16, tank_radius, tank_max_health, tank_max_speed));
-
-            //Get gridcell for tank
-            int gridIndex = Grid::GetGridIndex(position, gridSize, gridWidth);
-            if (gridIndex < 0 || gridIndex >= gridIndexBound)
-            {
-                //std::cout << "!ERROR! Tank out of bounds. This shouldn't happen Add Blue Tank!" << std::endl;
-                continue;
-            }
-            // store integer index of the grid that has to store num tank
-            _gridIndexes.push_back(gridIndex);
         }
-        return make_tuple(_tanks, _gridIndexes);
+        return _tanks;
     };
 
     auto spawnredtanks =
-        [start_red_x, max_rows, spacing, start_red_y, gridIndexBound, numToSpawn, redCounter, this]
-    () -> std::tuple<vector<Tank>, vector<int>>
+        [start_red_x, max_rows, spacing, start_red_y, numToSpawn, redCounter, this]
+    () -> vector<Tank>
     {
         vector<Tank> _tanks;
-        vector<int> _gridIndexes;
 
         std::unique_lock<std::mutex> locker(reds_mutex);
         for (int i = 0; i < numToSpawn; i++)
@@ -139,43 +194,51 @@ void Game::init()
 
             _tanks.push_back(Tank(position.x, position.y, RED, &tank_red, &smoke,
                 100.f, position.y + 16, tank_radius, tank_max_health, tank_max_speed));
-
-            //Get gridcell for tank
-            int gridIndex = Grid::GetGridIndex(position, gridSize, gridWidth);
-            if (gridIndex < 0 || gridIndex >= gridIndexBound)
-            {
-                //std::cout << "!ERROR! Tank out of bounds. This shouldn't happen Add RED Tank!" << std::endl;
-                continue;
-            }
-            _gridIndexes.push_back(gridIndex);
         }
-        return make_tuple(_tanks, _gridIndexes);
+        return _tanks;
     };
 
     //Split the work across the threads for red and blue tanks equally
-    vector<std::future<std::tuple<vector<Tank>, vector<int>>>> results;
+    vector<std::future<vector<Tank>>> results;
     for (auto i = 0; i < thread_count; i++)
     {
         //blue tanks
         auto resultBlue = thread_pool->returnenqueue(spawnbluetanks);
         results.push_back(std::move(resultBlue));
+    }
+    for (auto i = 0; i < thread_count; i++)
+    {
         //red tanks
         auto resultRed = thread_pool->returnenqueue(spawnredtanks);
         results.push_back(std::move(resultRed));
     }
 
     //Wait for all threads to finish TODO CHANGE INTO THREADED FUNCTION?!
-    //combine result into one vector and add to grids
-    for(auto r : results)
+    //combine result into one vector (blue tanks first, the health bars rely on that) and sort them into the grids
+    for(auto& r : results)
     {
-        auto val = r._Get_value();
-        auto _tanks = get<0>(val);
-        auto _gridIndexes = get<1>(val);
+        auto _tanks = r._Get_value();
         tanks.insert(end(tanks), begin(_tanks), end(_tanks));
-        for(auto i = 0; i < _tanks.size(); i++)
-        {
-            grids[_gridIndexes[i]].AddTank(_tanks[i]);
-        }
+    }
+    if (auto_tune_grid_size)
+    {
+        resize_grids(cell_size_tuner->pick(tanks, gridSize));
+    }
+
+    tank_slots.resize(tanks.size());
+    tank_handles.resize(tanks.size());
+    tank_last_tick.assign(tanks.size(), frame_count - 1);
+    for (size_t i = 0; i < tanks.size(); i++)
+    {
+        tank_slots[i] = (int)i;
+        tank_handles[i] = (int)i;
+    }
+    rebin_grids();
+
+    //Every tank fires on the first frame
+    for (size_t i = 0; i < tanks.size(); i++)
+    {
+        reload_timers.schedule((int)i, 0);
     }
 
     //Unlock update
@@ -213,9 +276,10 @@ void Game::init()
         }*/
     }
 
-    particle_beams.push_back(Particle_beam(vec2(590, 327), vec2(100, 50), &particle_beam_sprite, particle_beam_hit_value));
-    particle_beams.push_back(Particle_beam(vec2(64, 64), vec2(100, 50), &particle_beam_sprite, particle_beam_hit_value));
-    particle_beams.push_back(Particle_beam(vec2(1200, 600), vec2(100, 50), &particle_beam_sprite, particle_beam_hit_value));
+    particle_beams.push_back(Particle_beam(vec2(590, 327), vec2(100, 50), &particle_beam_sprite, particle_beam_hit_value, frame_count));
+    particle_beams.push_back(Particle_beam(vec2(64, 64), vec2(100, 50), &particle_beam_sprite, particle_beam_hit_value, frame_count));
+    particle_beams.push_back(Particle_beam(vec2(1200, 600), vec2(100, 50), &particle_beam_sprite, particle_beam_hit_value, frame_count));
+    beam_index.build(particle_beams, tank_radius, gridSize, gridWidth, gridHeight);
 
     //cout << "Initialization done. Got: " << tanks.size() << " Tanks. Spread over " << gridsCount << " grids." << endl;
 }
@@ -233,66 +297,260 @@ void Game::shutdown()
 // -----------------------------------------------------------
 Tank& Game::find_closest_enemy(Tank& current_tank)
 {
-    int gridIndex = Grid::GetGridIndex(current_tank.position, gridSize, background_terrain.GetWidth());
+    return (current_tank.allignment == BLUE) ? find_closest_enemy_of<RED>(current_tank) : find_closest_enemy_of<BLUE>(current_tank);
+}
+
+//Only looks at the tanks of the enemy team, so the team is no longer checked per candidate
+template <allignments enemy>
+Tank& Game::find_closest_enemy_of(Tank& current_tank)
+{
+    int gridIndex = Grid::GetGridIndex(current_tank.position, gridSize, gridWidth);
     if (gridIndex < 0 || gridIndex >= grids.size())
     {
         //std::cout << "!ERROR! Tank out of bounds. This shouldn't happen. CLOSEST ENEMY" << std::endl;
         return current_tank;
     }
     
-    Grid& currentGrid = grids[gridIndex];
+    //closest grid that has tanks of enemy color is a lookup in the distance field of this frame
+    int closestGridIndex = distance_field.nearest(enemy, gridIndex);
 
-    //find closest grid that has tanks of enemy color
-    size_t closestGridIndex = -1;
-    float closestGridDistance = numeric_limits<float>::infinity();
-    for (size_t i = 0; i < grids.size(); i++)
+    if(closestGridIndex == -1)
     {
-        if(grids.at(i).hasTanks == false || grids.at(i).indentifier == currentGrid.indentifier)
-            continue;
+        //std::cout << "!ERROR! closest grid index faulty" << std::endl;
+        return current_tank;
+    }
 
-        //Check if enemy tanks exist in grid
-        if(current_tank.allignment == allignments::BLUE && grids.at(i).hasRedTanks == false)
-            continue;
-        if(current_tank.allignment == allignments::RED && grids.at(i).hasBlueTanks == false)
-            continue;
+    //The closest tank isn't always in the grid with the closest center, so also check the enemy grids around it
+    const int fieldWidth = (int)distance_field.get_width();
+    const int fieldHeight = (int)distance_field.get_height();
+    const int closestX = closestGridIndex % fieldWidth;
+    const int closestY = closestGridIndex / fieldWidth;
 
-        float sqr_dist = fabsf((grids.at(i).GetCenter() - current_tank.get_position()).sqr_length());
-        if (sqr_dist < closestGridDistance)
+    float closestTankDistance = numeric_limits<float>::infinity();
+    Tank* closestTank = nullptr;
+    for (int y = std::max(closestY - 1, 0); y <= std::min(closestY + 1, fieldHeight - 1); y++)
+    {
+        for (int x = std::max(closestX - 1, 0); x <= std::min(closestX + 1, fieldWidth - 1); x++)
         {
-            closestGridIndex = i;
-            closestGridDistance = sqr_dist;
+            const int neighbourIndex = y * fieldWidth + x;
+            if (occupancy.test(enemy, neighbourIndex) == false)
+                continue;
+
+            for(Tank& tank : grids[neighbourIndex].GetTeamTanks<enemy>(tanks, grid_tanks))
+            {
+                float sqr_dist = fabsf((tank.position - current_tank.get_position()).sqr_length());
+                if (sqr_dist < closestTankDistance)
+                {
+                    closestTankDistance = sqr_dist;
+                    closestTank = &tank;
+                }
+            }
         }
     }
+    return *closestTank;
+}
 
-    if(closestGridIndex == -1)
+TankRange Game::tanks_in(const Grid& grid)
+{
+    return grid.GetTanks(tanks, grid_tanks);
+}
+
+TankRange Game::team_tanks_in(const Grid& grid, allignments team)
+{
+    return grid.GetTeamTanks(team, tanks, grid_tanks);
+}
+
+//Fire a rocket from every tank whose reload timer ends this frame and start its next reload
+//Only the due tanks are visited, they are split over the threads and their rockets are added in timer order
+void Game::fire_reloaded_tanks()
+{
+    due_tanks.clear();
+    reload_timers.advance(frame_count, due_tanks);
+    if (due_tanks.empty()) return;
+
+    const vector<Grid_range> chunks = Grid_partitioner::split_evenly(due_tanks.size(), thread_count);
+
+    vector<Rocket_pool> fired_rockets(chunks.size());
+    run_partitioned(*thread_pool, chunks, [this, &chunks, &fired_rockets](const Grid_range& chunk)
     {
-        //std::cout << "!ERROR! closest grid index faulty" << std::endl;
+        Rocket_pool& chunk_rockets = fired_rockets[&chunk - chunks.data()];
+        for (size_t i = chunk.begin; i < chunk.end; i++)
+        {
+            Tank& t = tanks[tank_slots[due_tanks[i]]];
+            if (t.active == false)
+                continue;
+
+            Tank& target = find_closest_enemy(t);
+
+            //No target (tank left the map or no enemies left), try again after the next reload
+            if (&target == &t)
+                continue;
+
+            chunk_rockets.add(t.position, (target.get_position() - t.position).normalized() * rocket_speed, t.allignment);
+        }
+    });
+
+    for (const Rocket_pool& chunk_rockets : fired_rockets)
+    {
+        const size_t first_new = rockets.size();
+        rockets.append(chunk_rockets);
+
+        for (size_t i = first_new; i < rockets.size(); i++)
+        {
+            rocket_scheduler.schedule(rockets.get_id(i), frame_count);
+        }
     }
 
-    Grid& closestGrid = grids[closestGridIndex];
-    vector<Tank>& closestGridTanks = closestGrid.GetTanks();
-    float closestTankDistance = numeric_limits<float>::infinity();
-    int closestTankIndex = 0;
-    for(size_t i = 0; i < closestGridTanks.size(); i++)
-    {
-        Tank& tank = closestGridTanks[i];
-        if(tank.allignment == current_tank.allignment)
-            continue;
-        
-        float sqr_dist = fabsf((tank.position - current_tank.get_position()).sqr_length());
-        if (sqr_dist < closestTankDistance)
+    //Destroyed tanks drop out of the schedule
+    for (int tank_handle : due_tanks)
+    {
+        if (tanks[tank_slots[tank_handle]].active)
+        {
+            reload_timers.schedule(tank_handle, frame_count + rocket_reload_frames);
+        }
+    }
+}
+
+//Compact the awake tanks that tick this frame into ticking_tanks, in grid order
+//How often a tank ticks depends on the distance from its grid to the closest enemy grid
+void Game::collect_ticking_tanks()
+{
+    //A tick never covers more frames than the longest interval, the rocket scheduler relies on that bound
+    const long long max_tick_frames = std::max(1, lod.get_settings().far_interval);
+
+    const vector<Grid_range> ranges = Grid_partitioner::partition(grids, thread_count);
+    vector<vector<Tank_tick>> range_ticks(ranges.size());
+    run_partitioned(*thread_pool, ranges, [this, &ranges, &range_ticks, max_tick_frames](const Grid_range& range)
+    {
+        vector<Tank_tick>& ticks = range_ticks[&range - ranges.data()];
+        occupancy.for_each_occupied(range.begin, range.end, [this, &ticks, max_tick_frames](size_t i)
+        {
+            for (int team = BLUE; team <= RED; team++)
+            {
+                const int interval = lod.tick_interval(distance_field.grid_distance(enemy_of((allignments)team), i) * gridSize);
+                for (Tank& t : team_tanks_in(grids[i], (allignments)team))
+                {
+                    const int tank_index = (int)(&t - tanks.data());
+                    const int tank_handle = tank_handles[tank_index];
+
+                    //A sleeping tank doesn't move, so it has nothing to catch up on once it wakes
+                    if (t.is_sleeping())
+                    {
+                        tank_last_tick[tank_handle] = frame_count;
+                        continue;
+                    }
+
+                    //Staggered on the handle, the index changes when the tanks get reordered
+                    //The tick covers the frames since the last one, which differs from the interval when it just changed
+                    if (Lod_scheduler::ticks_on(frame_count, tank_handle, interval))
+                    {
+                        const int frames = (int)std::min<long long>(frame_count - tank_last_tick[tank_handle], max_tick_frames);
+                        tank_last_tick[tank_handle] = frame_count;
+                        ticks.push_back({tank_index, std::max(1, frames)});
+                    }
+                }
+            }
+        });
+    });
+
+    ticking_tanks.clear();
+    for (vector<Tank_tick>& ticks : range_ticks)
+    {
+        ticking_tanks.insert(ticking_tanks.end(), ticks.begin(), ticks.end());
+    }
+}
+
+//Runs the collision pass of every backend on its own copy of the tanks of this frame and prints how long each took
+//and how many tanks got pushed, the game itself continues with the selected backend
+void Game::run_broadphase_benchmark()
+{
+    cout << "Broadphase benchmark, frame " << frame_count << ":" << endl;
+    for (std::unique_ptr<Broadphase>& backend : benchmark_broadphases)
+    {
+        vector<Tank> tanks_copy = tanks;
+
+        timer backend_timer;
+        backend->build(tanks_copy, *thread_pool, thread_count);
+        backend->collide(tanks_copy, *thread_pool, thread_count);
+        const float backend_duration = backend_timer.elapsed();
+
+        const auto pushed = std::count_if(tanks_copy.begin(), tanks_copy.end(), [](const Tank& t) { return t.force != vec2(0.f, 0.f); });
+        cout << "    " << backend->get_name() << ": " << backend_duration << " ms, " << pushed << " tanks pushed" << endl;
+    }
+}
+
+//Runs the collision pass and blits the tanks on two copies of the tanks of this frame, one in spawn order and one
+//in the Z-curve order the game keeps them in, and prints how long each took
+//The blits are not sorted, so they follow the tank storage order like the tank reads do
+void Game::run_morton_benchmark()
+{
+    //A handle is the index the tank was spawned at, the grids of the copy point at handles instead of slots
+    vector<Tank> spawn_tanks;
+    spawn_tanks.reserve(tanks.size());
+    for (size_t handle = 0; handle < tanks.size(); handle++)
+    {
+        spawn_tanks.push_back(tanks[tank_slots[handle]]);
+    }
+    vector<int> spawn_grid_tanks(grid_tanks.size());
+    for (size_t i = 0; i < grid_tanks.size(); i++)
+    {
+        spawn_grid_tanks[i] = tank_handles[grid_tanks[i]];
+    }
+
+    Surface target(SCRWIDTH, SCRHEIGHT);
+    Render_buffer buffer;
+
+    cout << "Tank order benchmark, frame " << frame_count << ":" << endl;
+    auto run = [&](const char* name, vector<Tank> tanks_copy, const vector<int>& copy_grid_tanks)
+    {
+        Uniform_grid_broadphase backend(grids, copy_grid_tanks, occupancy);
+        timer collision_timer;
+        backend.collide(tanks_copy, *thread_pool, thread_count);
+        const float collision_duration = collision_timer.elapsed();
+
+        buffer.clear();
+        for (const Tank& t : tanks_copy)
         {
-            closestTankDistance = sqr_dist;
-            closestTankIndex = i;
+            if (t.active) t.draw(buffer, frame_count);
         }
+        target.clear(0);
+        timer blit_timer;
+        buffer.submit(&target);
+        const float blit_duration = blit_timer.elapsed();
+
+        cout << "    " << name << ": collision pass " << collision_duration << " ms, " << buffer.size() << " tank blits " << blit_duration << " ms" << endl;
+    };
+    run("spawn order", std::move(spawn_tanks), spawn_grid_tanks);
+    run("Z-curve order", tanks, grid_tanks);
+}
+
+//Cover the map with grids of the given size, the grids are empty until the next rebin
+void Game::resize_grids(int grid_size)
+{
+    gridSize = grid_size;
+    gridWidth = (size_t)std::ceil(world_size.x / gridSize);
+    gridHeight = (size_t)std::ceil(world_size.y / gridSize);
+
+    const size_t gridsCount = gridWidth * gridHeight;
+    grids = vector<Grid>(gridsCount);
+    for (size_t i = 0; i < gridsCount; i++)
+    {
+        vec2 position{(float)(i % gridWidth) * gridSize, (float)(i / gridWidth) * gridSize};
+        grids[i] = Grid(position, position + vec2((float)gridSize, (float)gridSize), (int)i);
     }
-    return closestGridTanks[closestTankIndex];
+
+    occupancy.resize(gridWidth, gridHeight);
+    distance_field.resize(gridWidth, gridHeight);
+    beam_index.build(particle_beams, tank_radius, gridSize, gridWidth, gridHeight);
 }
 
-//Checks if a point lies on the left of an arbitrary angled line
-bool Tmpl8::Game::left_of_line(vec2 line_start, vec2 line_end, vec2 point)
+//Sort all tanks into the grid they are currently in
+void Game::rebin_grids()
 {
-    return ((line_end.x - line_start.x) * (point.y - line_start.y) - (line_end.y - line_start.y) * (point.x - line_start.x)) < 0;
+    grid_rebinner.rebin(tanks, grids, grid_tanks, occupancy, gridSize, gridWidth, *thread_pool, thread_count);
+
+    //Closest enemy grid for every grid, used by the targeting of the next frame
+    distance_field.build(occupancy, *thread_pool, thread_count);
 }
 
 //Optimized
@@ -305,268 +563,201 @@ bool Tmpl8::Game::left_of_line(vec2 line_start, vec2 line_end, vec2 point)
 // -----------------------------------------------------------
 void Game::update(float deltaTime)
 {
-    const size_t gridWidth = background_terrain.GetWidth();
-    
     //optimized
     //Calculate the route to the destination for each tank using BFS
     //Initializing routes here so it gets counted for performance..
     if (frame_count == 0)
     {
-        for(Grid& g : grids)
+        occupancy.for_each_occupied([this](size_t i)
         {
-            if(g.hasTanks == false)
-                continue;
-            for(Tank& t : g.GetTanks())
+            for(Tank& t : tanks_in(grids[i]))
             {
                 t.set_route(background_terrain.get_route(t, t.target));
             }
-        }
+        });
         //std::cout << "Done with Routes" << std::endl;
     }
     
-    /// Optimized
-    /// new check using grids offset tanks on collision
-    for(Grid& g : grids)
+    //Optimized
+    //Offset tanks on collision, how overlapping tanks are found depends on the backend
+    if (broadphase_benchmark_interval > 0 && frame_count % broadphase_benchmark_interval == 0)
     {
-        for(Tank& t : g.GetTanks())
-        {
-            for(Tank& ot : g.GetTanks())
-            {
-                if (&t == &ot) continue;
-
-                vec2 dir = t.get_position() - ot.get_position();
-                float dir_squared_len = dir.sqr_length();
-
-                float col_squared_len = (t.get_collision_radius() + ot.get_collision_radius());
-                col_squared_len *= col_squared_len;
-
-                if (dir_squared_len < col_squared_len)
-                {
-                    t.push(dir.normalized(), 1.f);
-                }
-            }
-        }
+        run_broadphase_benchmark();
+    }
+    if (morton_benchmark_interval > 0 && frame_count % morton_benchmark_interval == 0)
+    {
+        run_morton_benchmark();
     }
 
+    timer pass_timer;
+    broadphase->build(tanks, *thread_pool, thread_count);
+    broadphase->collide(tanks, *thread_pool, thread_count);
+    collision_pass_duration += pass_timer.elapsed();
+
     //optimized
     //Update tanks
-    vector<Tank> tanks_without_grid = vector<Tank>();
-    for(Grid& g : grids)
-    {
-        if(g.hasTanks == false)
-            continue;
-        for(Tank& t : g.GetTanks())
+    //Tanks read the positions of this frame and write the next frame, so the grids can be ticked
+    //in parallel without locks and the result doesn't depend on the order the grids are processed in
+    //Destroyed tanks are not in any grid and sleeping tanks are skipped, so only the awake tanks cost anything
+    //Tanks far away from the enemy only tick every few frames (see lod)
+    collect_ticking_tanks();
+    const vector<Grid_range> tick_ranges = Grid_partitioner::split_evenly(ticking_tanks.size(), thread_count);
+    run_partitioned(*thread_pool, tick_ranges, [this](Grid_range range)
+    {
+        for (size_t i = range.begin; i < range.end; i++)
         {
-            t.tick(background_terrain);
+            tanks[ticking_tanks[i].tank].tick(background_terrain, ticking_tanks[i].frames);
+        }
+    });
 
-            //Shoot at closest target if reloaded
-            if (t.rocket_reloaded())
-            {
-                Tank& target = find_closest_enemy(t);
-                rockets.push_back(Rocket(t.position, (target.get_position() - t.position).normalized() * 3, rocket_radius, t.allignment, ((t.allignment == RED) ? &rocket_red : &rocket_blue)));
+    //Shoot at closest target with the tanks that finished reloading this frame
+    fire_reloaded_tanks();
 
-                t.reload_rocket();
-            }
+    //All tanks are done reading this frame, make the next frame current
+    run_partitioned(*thread_pool, tick_ranges, [this](Grid_range range)
+    {
+        for (size_t i = range.begin; i < range.end; i++)
+        {
+            tanks[ticking_tanks[i].tank].swap_buffers();
         }
-        vector<Tank> outbounds = g.GetTanksOutBounds();
-        tanks_without_grid.insert(tanks_without_grid.end(), outbounds.begin(), outbounds.end());
+    });
+
+    //Keep tanks that are close on the map close in memory, the grid_tanks indices are rebuilt right after
+    if (morton_reorder_interval > 0 && frame_count % morton_reorder_interval == 0)
+    {
+        morton_order.reorder(tanks, tank_slots, tank_handles, (float)gridSize, *thread_pool, thread_count);
     }
 
-    for(Tank& t : tanks_without_grid)
+    //The tanks clump together or spread out over time, check if another grid size fits them better
+    if (auto_tune_grid_size && grid_retune_interval > 0 && frame_count > 0 && frame_count % grid_retune_interval == 0)
     {
-        int gridIndex = Grid::GetGridIndex(t.position, gridSize, gridWidth);
-        if (gridIndex < 0 || gridIndex >= grids.size())
+        const int tuned_grid_size = cell_size_tuner->pick(tanks, gridSize);
+        if (tuned_grid_size != gridSize)
         {
-            //std::cout << "!ERROR! Tank out of bounds. This shouldn't happen UPDATE ACTIVE TANKS" << std::endl;
-            continue;
+            resize_grids(tuned_grid_size);
         }
-        grids[gridIndex].AddTank(t);
     }
+
+    //Move the tanks that crossed a grid border to their new grid (also refreshes the occupancy bitmaps)
+    rebin_grids();
     
-    //Update smoke plumes
-    for (Smoke& smoke : smokes)
-    {
-        smoke.tick();
-    }
+    //Smoke plumes animate on their own, old plumes fade out after their lifetime
+    smokes.tick();
 
-    //Calculate "forcefield" around active tanks
-    forcefield_hull.clear();
+    //Calculate "forcefield" around active tanks, starting from the hull of the last frame
+    forcefield_hull.update(tanks, tank_slots, tank_handles, grids, grid_tanks, occupancy, gridSize, gridWidth, gridHeight);
 
-    vec2 point_found_on_hull = vec2();
-    Tank* FirstActive = nullptr;
+    //Remove finished explosions
+    explosions.tick();
 
-    vector<Tank> ActiveTanks = vector<Tank>();
+    //Update rockets /// ALTERED
+    rockets.tick();
+
+    //Stray rockets can't hit anything anymore, drop them before they cost collision, hull and draw time
+    rockets.cull(vec2(0.f, 0.f), world_size, rocket_radius + tank_radius, rocket_lifetime_frames);
 
-    for(Grid& g : grids)
+    //Only enemies can be hit, rockets are checked against the tanks in their grid and the grids around it
+    //Rockets far from any enemy wait in the event queue until they could have come close enough
+    if (rocket_event_queue)
     {
-        if(g.hasTanks == false)
-            continue;
-        
-        ActiveTanks.insert(ActiveTanks.end(), g.GetTanks().begin(), g.GetTanks().end());
+        rocket_scheduler.collect_due(rockets, frame_count, checked_rockets);
     }
-
-    //Calculate "forcefield" around active tanks
-    forcefield_hull.clear();
-
-    //Find first active tank (this loop is a bit disgusting, fix?)
-    int first_active = 0;
-    for (Tank& tank : ActiveTanks)
+    else
     {
-        if (tank.active)
-        {
-            break;
-        }
-        first_active++;
+        checked_rockets.resize(rockets.size());
+        std::iota(checked_rockets.begin(), checked_rockets.end(), 0);
     }
-    vec2 point_on_hull = ActiveTanks.at(first_active).position;
 
-    //Find left most tank position
-    for (Tank& tank : ActiveTanks)
+    rocket_collider.collide(rockets, checked_rockets, tanks, grids, grid_tanks, gridSize, gridWidth, gridHeight, rocket_hit_value, rocket_hits);
+    for (const Rocket_hit& hit : rocket_hits)
     {
-        if (tank.active)
+        const Tank& tank = tanks[hit.tank];
+        explosions.spawn(Explosion(&explosion, tank.position, frame_count));
+
+        if (hit.destroyed)
         {
-            if (tank.position.x <= point_on_hull.x)
-            {
-                point_on_hull = tank.position;
-            }
+            smokes.spawn(Smoke(&smoke, tank.position - vec2(7, 24), frame_count));
+            tank_decals.push_back(tank.make_decal(frame_count));
         }
     }
 
-    //Calculate convex hull for 'rocket barrier'
-    for (Tank& tank : ActiveTanks)
+    //Exploded rockets are swapped with the last rocket and popped, from the back so the other hit indices stay valid
+    for (auto hit = rocket_hits.rbegin(); hit != rocket_hits.rend(); ++hit)
     {
-        if (tank.active)
-        {
-            forcefield_hull.push_back(point_on_hull);
-            vec2 endpoint = tanks.at(first_active).position;
-
-            for (Tank& tank : ActiveTanks)
-            {
-                if (tank.active)
-                {
-                    if ((endpoint == point_on_hull) || left_of_line(point_on_hull, endpoint, tank.position))
-                    {
-                        endpoint = tank.position;
-                    }
-                }
-            }
-            point_on_hull = endpoint;
-
-            if (endpoint == forcefield_hull.at(0))
-            {
-                break;
-            }
-        }
+        rockets.remove(hit->rocket);
     }
 
-    //Update explosions
-    for (Explosion& explosion : explosions)
+    if (rocket_event_queue)
     {
-        explosion.tick();
+        rocket_scheduler.reschedule(rockets, frame_count, distance_field, gridSize, tank_radius);
     }
 
-    //Update rockets /// ALTERED
-    for (Rocket& rocket : rockets)
+    //Disable rockets if they collide with the "forcefield" around active tanks
+    //Hint: A point to convex hull intersection test might be better here? :) (Disable if outside)
+    const vector<vec2>& hull = forcefield_hull.get_points();
+    for (size_t r = 0; r < rockets.size();)
     {
-        rocket.tick();
-
-        int gridIndex = Grid::GetGridIndex(rocket.position, gridSize, gridWidth);
-        if (gridIndex < 0 || gridIndex >= grids.size())
+        bool exploded = false;
+        for (size_t i = 0; i < hull.size(); i++)
         {
-            //std::cout << "!ERROR! Rocket out of bounds. This shouldn't happen CHECK ROCKETS" << std::endl;
-            continue;
+            if (circle_segment_intersect(hull.at(i), hull.at((i + 1) % hull.size()), rockets.get_position(r), rockets.get_collision_radius()))
+            {
+                explosions.spawn(Explosion(&explosion, rockets.get_position(r), frame_count));
+                exploded = true;
+            }
         }
 
-        Grid& g = grids[gridIndex];
-        for (Tank& tank : g.GetTanks())
+        if (exploded)
+            rockets.remove(r);
+        else
+            r++;
+    }
+    
+    //Update particle beams //// Altered
+    //Damage all tanks within the damage window of the beams (the window is an axis-aligned bounding box)
+    auto beam_hit = [this](const Particle_beam& particle_beam, Tank& t)
+    {
+        if (t.active == false)
+            return;
+
+        if (particle_beam.rectangle.intersects_circle(t.get_position(), t.get_collision_radius()))
         {
-            if(tank.active == false)
-                continue;
-            
-            if ((tank.allignment != rocket.allignment) && rocket.intersects(tank.position, tank.collision_radius))
+            if (t.hit(particle_beam.damage))
             {
-                explosions.push_back(Explosion(&explosion, tank.position));
-
-                if (tank.hit(rocket_hit_value))
-                {
-                    smokes.push_back(Smoke(smoke, tank.position - vec2(7, 24)));
-                }
-
-                rocket.active = false;
-                break;
+                smokes.spawn(Smoke(&smoke, t.position - vec2(0, 48), frame_count));
+                tank_decals.push_back(t.make_decal(frame_count));
             }
         }
-    }
+    };
 
-    //Disable rockets if they collide with the "forcefield" around active tanks
-    //Hint: A point to convex hull intersection test might be better here? :) (Disable if outside)
-    for (Rocket& rocket : rockets)
+    //With many beams over few tanks, go from the occupied grids to the beams reaching them instead
+    if (occupancy.count(BLUE) + occupancy.count(RED) < beam_index.get_covered_grid_count())
     {
-        if (rocket.active)
+        occupancy.for_each_occupied([this, &beam_hit](size_t i)
         {
-            for (size_t i = 0; i < forcefield_hull.size(); i++)
+            const Rectangle2D area(grids[i].GetTopLeft(), grids[i].GetBottomRight());
+            beam_index.query(area, [this, &beam_hit, i](size_t beam)
             {
-                if (circle_segment_intersect(forcefield_hull.at(i), forcefield_hull.at((i + 1) % forcefield_hull.size()), rocket.position, rocket.collision_radius))
+                for (Tank& t : tanks_in(grids[i]))
                 {
-                    explosions.push_back(Explosion(&explosion, rocket.position));
-                    rocket.active = false;
+                    beam_hit(particle_beams[beam], t);
                 }
-            }
-        }
+            });
+        });
     }
-
-    //optimized
-    //Remove exploded rockets with remove erase idiom
-    rockets.erase(std::remove_if(rockets.begin(), rockets.end(), [](const Rocket& rocket) { return !rocket.active; }), rockets.end());
-    
-    //Update particle beams //// Altered
-    for (Particle_beam& particle_beam : particle_beams)
+    else
     {
-        particle_beam.tick(tanks);
-
-        //Get grids in range of the beam
-        vec2 TL = particle_beam.min_position;
-        vec2 BR = particle_beam.max_position;
-        vec2 TR = vec2(BR.x, TL.y);
-        vec2 BL = vec2(TL.x, BR.y);
-
-        vector<Grid> gridsInRange;
-        gridsInRange.push_back(grids[Grid::GetGridIndex(TL, gridSize, gridWidth)]);
-        gridsInRange.push_back(grids[Grid::GetGridIndex(BR, gridSize, gridWidth)]);
-        gridsInRange.push_back(grids[Grid::GetGridIndex(TR, gridSize, gridWidth)]);
-        gridsInRange.push_back(grids[Grid::GetGridIndex(BL, gridSize, gridWidth)]);
-
-        for(Grid& g : gridsInRange)
+        for (size_t beam = 0; beam < particle_beams.size(); beam++)
         {
-            if(g.hasTanks == false)
-                continue;
-            
-            //Damage all tanks within the damage window of the beam (the window is an axis-aligned bounding box)
-            for(Tank& t : g.GetTanks())
+            beam_index.for_each_covered_grid(beam, [this, &beam_hit, beam](size_t i)
             {
-                if(t.active == false)
-                    continue;
-                
-                if (particle_beam.rectangle.intersects_circle(t.get_position(), t.get_collision_radius()))
+                for (Tank& t : tanks_in(grids[i]))
                 {
-                    if (t.hit(particle_beam.damage))
-                    {
-                        smokes.push_back(Smoke(smoke, t.position - vec2(0, 48)));
-                    }
+                    beam_hit(particle_beams[beam], t);
                 }
-            }
+            });
         }
     }
-
-    //optimized
-    //Update explosion sprites and remove when done with remove erase idiom
-    for (Explosion& explosion : explosions)
-    {
-        explosion.tick();
-    }
-    
-    //optimized
-    explosions.erase(std::remove_if(explosions.begin(), explosions.end(), [](const Explosion& explosion) { return explosion.done(); }), explosions.end());
 }
 
 //optimized
@@ -582,44 +773,49 @@ void Game::draw()
     //Draw background
     background_terrain.draw(screen);
     
-    tanks.clear();
     //Draw sprites /// Altered
-    for(Grid& g : grids)
+    //Everything goes into the render buffer first and is drawn sorted by layer, sprite sheet and row
+    render_buffer.clear();
+    for (const Tank_decal& decal : tank_decals)
     {
-        if(!g.hasTanks)
-            continue;
-        for(Tank& t : g.GetTanks())
+        decal.draw(render_buffer, DECAL_LAYER);
+    }
+
+    timer pass_timer;
+    occupancy.for_each_occupied([this](size_t i)
+    {
+        for(Tank& t : tanks_in(grids[i]))
         {
-            t.draw(screen);
-            tanks.push_back(t);
+            //Destroyed this frame, already drawn as a decal
+            if (t.active == false)
+                continue;
+            t.draw(render_buffer, frame_count);
         }
-    }
+    });
+    tank_queue_pass_duration += pass_timer.elapsed();
     
-    for (Rocket& rocket : rockets)
-    {
-        rocket.draw(screen);
-    }
+    rockets.draw(render_buffer);
 
-    for (Smoke& smoke : smokes)
-    {
-        smoke.draw(screen);
-    }
+    smokes.for_each([this](const Smoke& smoke) { smoke.draw(render_buffer, frame_count); });
 
     for (Particle_beam& particle_beam : particle_beams)
     {
-        particle_beam.draw(screen);
+        particle_beam.draw(render_buffer, frame_count);
     }
 
-    for (Explosion& explosion : explosions)
-    {
-        explosion.draw(screen);
-    }
+    explosions.for_each([this](const Explosion& explosion) { explosion.draw(render_buffer, frame_count); });
+
+    timer submit_timer;
+    render_buffer.sort();
+    render_buffer.submit(screen);
+    sprite_submit_duration += submit_timer.elapsed();
 
     //Draw forcefield (mostly for debugging, its kinda ugly..)
-    for (size_t i = 0; i < forcefield_hull.size(); i++)
+    const vector<vec2>& hull = forcefield_hull.get_points();
+    for (size_t i = 0; i < hull.size(); i++)
     {
-        vec2 line_start = forcefield_hull.at(i);
-        vec2 line_end = forcefield_hull.at((i + 1) % forcefield_hull.size());
+        vec2 line_start = hull.at(i);
+        vec2 line_end = hull.at((i + 1) % hull.size());
         line_start.x += HEALTHBAR_OFFSET;
         line_end.x += HEALTHBAR_OFFSET;
         screen->line(line_start, line_end, 0x0000ff);
@@ -720,6 +916,10 @@ void Tmpl8::Game::measure_performance()
         {
             duration = perf_timer.elapsed();
             cout << "Duration was: " << duration << " (Replace REF_PERFORMANCE with this value)" << endl;
+            cout << "Rockets culled: " << rockets.get_culled_count() << endl;
+            cout << "Effects dropped (pool full): " << explosions.get_dropped_count() << " explosions, " << smokes.get_dropped_count() << " smoke plumes" << endl;
+            cout << "Collision pass: " << collision_pass_duration << " ms, tank queue pass: " << tank_queue_pass_duration << " ms (Z-curve reorder every " << morton_reorder_interval << " frames)" << endl;
+            cout << "Sorted sprite submit: " << sprite_submit_duration << " ms" << endl;
             lock_update = true;
         }
 
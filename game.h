@@ -1,12 +1,12 @@
 #pragma once
 
 class Grid;
+class TankRange;
 
 namespace Tmpl8
 {
 //forward declarations
 class Tank;
-class Rocket;
 class Smoke;
 class Particle_beam;
 
@@ -24,6 +24,18 @@ class Game
     void measure_performance();
 
     Tank& find_closest_enemy(Tank& current_tank);
+    template <allignments enemy>
+    Tank& find_closest_enemy_of(Tank& current_tank);
+
+    //The tanks stored in the given grid
+    TankRange tanks_in(const Grid& grid);
+    TankRange team_tanks_in(const Grid& grid, allignments team);
+    void resize_grids(int grid_size);
+    void rebin_grids();
+    void fire_reloaded_tanks();
+    void collect_ticking_tanks();
+    void run_broadphase_benchmark();
+    void run_morton_benchmark();
 
     void mouse_up(int button)
     { /* implement if you want to detect mouse button presses */
@@ -49,30 +61,72 @@ class Game
     Surface* screen;
 
     vector<Tank> tanks;
-    vector<Rocket> rockets;
-    vector<Smoke> smokes;
-    vector<Explosion> explosions;
+    Rocket_pool rockets;
+    Rocket_collider rocket_collider;
+    Rocket_scheduler rocket_scheduler;
+    vector<int> checked_rockets;
+    vector<Rocket_hit> rocket_hits;
+    Effect_pool<Smoke> smokes;
+    Effect_pool<Explosion> explosions;
     vector<Particle_beam> particle_beams;
+    Beam_index beam_index;
+    vector<Tank_decal> tank_decals;
+    Render_buffer render_buffer;
 
     Terrain background_terrain;
-    std::vector<vec2> forcefield_hull;
+    Forcefield_hull forcefield_hull;
 
     Font* frame_count_font;
     long long frame_count = 0;
 
     bool lock_update = false;
 
-    //Checks if a point lies on the left of an arbitrary angled line
-    bool left_of_line(vec2 line_start, vec2 line_end, vec2 point);
-
     //Grid System
+    //The grids cover the map independent of the terrain tiles, their size can change while running
     vector<Grid> grids;
     int gridSize = 16;
+    size_t gridWidth = 0;
+    size_t gridHeight = 0;
+    vec2 world_size;
+    std::unique_ptr<Cell_size_tuner> cell_size_tuner;
+
+    //Indices into tanks, sorted by grid. Every grid owns a range of this array
+    vector<int> grid_tanks;
+
+    //Tanks to tick this frame and how many frames the tick covers
+    struct Tank_tick
+    {
+        int tank;
+        int frames;
+    };
+    vector<Tank_tick> ticking_tanks;
+    Lod_scheduler lod;
+
+    //Tank collision, selected at startup
+    std::unique_ptr<Broadphase> broadphase;
+    vector<std::unique_ptr<Broadphase>> benchmark_broadphases;
+    Grid_rebinner grid_rebinner;
+
+    //Which grids hold tanks, per team
+    Occupancy_bitmap occupancy;
+    Distance_field distance_field;
+
+    //tanks is reordered along the Z-curve every now and then, anything that has to find a tank
+    //again later (like the reload timers) keeps its handle, tank_slots maps a handle to its index in tanks
+    vector<int> tank_slots;
+    vector<int> tank_handles;
+    Morton_order morton_order;
+
+    //Last frame each tank (by handle) ticked or lay asleep, a tick moves the tank over the frames since then
+    vector<long long> tank_last_tick;
+
+    //Tank handles by the frame their rocket is reloaded
+    Timer_wheel reload_timers;
+    vector<int> due_tanks;
 
     //thread pool
     int thread_count = 0;
     std::mutex tanks_mutex;
-    std::mutex grids_mutex;
     std::mutex reds_mutex;
     std::mutex blues_mutex;
 
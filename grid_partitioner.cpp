@@ -0,0 +1,58 @@
+#include "precomp.h"
+#include "grid_partitioner.h"
+
+namespace Tmpl8
+{
+
+vector<Grid_range> Grid_partitioner::partition(const vector<Grid>& grids, size_t chunk_count)
+{
+    return partition(grids, chunk_count, [](size_t tank_count) { return tank_count; });
+}
+
+vector<Grid_range> Grid_partitioner::split_evenly(size_t count, size_t chunk_count)
+{
+    chunk_count = std::max<size_t>(1, std::min(chunk_count, count));
+
+    vector<Grid_range> ranges(chunk_count);
+    for (size_t c = 0; c < chunk_count; c++)
+    {
+        ranges[c] = {count * c / chunk_count, count * (c + 1) / chunk_count};
+    }
+    return ranges;
+}
+
+vector<Grid_range> Grid_partitioner::split_prefix_sum(const vector<size_t>& prefix_sum, size_t chunk_count)
+{
+    vector<Grid_range> ranges;
+
+    const size_t cell_count = prefix_sum.size() - 1;
+    const size_t total_work = prefix_sum.back();
+    if (cell_count == 0 || chunk_count == 0) return ranges;
+
+    ranges.reserve(chunk_count);
+
+    size_t begin = 0;
+    for (size_t chunk = 1; chunk <= chunk_count && begin < cell_count; chunk++)
+    {
+        size_t end = cell_count;
+
+        if (chunk < chunk_count)
+        {
+            //First cell boundary at which the work done reaches this chunks share
+            const size_t target_work = total_work * chunk / chunk_count;
+            end = std::lower_bound(prefix_sum.begin() + begin + 1, prefix_sum.end(), target_work) - prefix_sum.begin();
+            end = std::min(end, cell_count);
+        }
+
+        //A single cell can't be split, so skip chunks that got no cells of their own
+        if (end > begin)
+        {
+            ranges.push_back({begin, end});
+            begin = end;
+        }
+    }
+
+    return ranges;
+}
+
+} // namespace Tmpl8
@@ -0,0 +1,63 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//Contiguous range of grid cells [begin, end) handed to a single worker
+struct Grid_range
+{
+    size_t begin;
+    size_t end;
+};
+
+class Grid_partitioner
+{
+  public:
+    //Split the grid cells into (at most) chunk_count ranges of roughly equal work
+    //Work per cell is given by cost(tank_count), visiting a cell always costs 1 extra
+    template <typename Cost>
+    static vector<Grid_range> partition(const vector<Grid>& grids, size_t chunk_count, Cost cost);
+
+    //Split by tank count, suits passes that do constant work per tank (tick, rebinning)
+    static vector<Grid_range> partition(const vector<Grid>& grids, size_t chunk_count);
+
+    //Cut a prefix sum of work into chunk_count ranges of roughly equal work
+    static vector<Grid_range> split_prefix_sum(const vector<size_t>& prefix_sum, size_t chunk_count);
+
+    //Cut [0, count) into (at most) chunk_count equal ranges, for lists where every item costs the same
+    static vector<Grid_range> split_evenly(size_t count, size_t chunk_count);
+};
+
+template <typename Cost>
+vector<Grid_range> Grid_partitioner::partition(const vector<Grid>& grids, size_t chunk_count, Cost cost)
+{
+    //prefix_sum[i] holds the work of all cells before cell i
+    vector<size_t> prefix_sum(grids.size() + 1, 0);
+    for (size_t i = 0; i < grids.size(); i++)
+    {
+        prefix_sum[i + 1] = prefix_sum[i] + cost(grids[i].GetTankCount()) + 1;
+    }
+
+    return split_prefix_sum(prefix_sum, chunk_count);
+}
+
+//Run func(range) for every range on the thread pool and wait until all of them are done
+//range refers into ranges, so &range - ranges.data() gives the index of the range
+template <typename Func>
+void run_partitioned(ThreadPool& pool, const vector<Grid_range>& ranges, Func func)
+{
+    vector<future<void>> jobs;
+    jobs.reserve(ranges.size());
+
+    for (const Grid_range& range : ranges)
+    {
+        jobs.push_back(pool.enqueue([&func, &range]() { func(range); }));
+    }
+
+    for (future<void>& job : jobs)
+    {
+        job.wait();
+    }
+}
+
+} // namespace Tmpl8
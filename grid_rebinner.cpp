@@ -0,0 +1,90 @@
+#include "precomp.h"
+#include "grid_rebinner.h"
+
+namespace Tmpl8
+{
+
+void Grid_rebinner::rebin(const vector<Tank>& tanks, vector<Grid>& grids, vector<int>& grid_tanks, Occupancy_bitmap& occupancy, int grid_size, size_t grid_width, ThreadPool& pool, size_t thread_count)
+{
+    const size_t tank_count = tanks.size();
+    const size_t grid_count = grids.size();
+
+    //Every tank costs the same here, so split the tanks in equal chunks of indices
+    const vector<Grid_range> chunks = Grid_partitioner::split_evenly(tank_count, thread_count);
+    const size_t chunk_count = chunks.size();
+
+    const size_t bin_count = grid_count * 2;
+
+    tank_bins.resize(tank_count);
+    chunk_counters.resize(chunk_count);
+
+    //Compute the bin of every tank and count the tanks per bin
+    run_partitioned(pool, chunks, [&](const Grid_range& chunk)
+    {
+        vector<int>& counters = chunk_counters[&chunk - chunks.data()];
+        counters.assign(bin_count, 0);
+
+        for (size_t i = chunk.begin; i < chunk.end; i++)
+        {
+            int bin = Grid::GetGridIndex(tanks[i].position, grid_size, grid_width);
+            if (bin < 0 || bin >= (int)grid_count || tanks[i].active == false)
+            {
+                //Tank left the map or got destroyed, it is no longer part of any grid
+                bin = -1;
+            }
+            else
+            {
+                bin = bin * 2 + tanks[i].allignment;
+                counters[bin]++;
+            }
+            tank_bins[i] = bin;
+        }
+    });
+
+    //Exclusive prefix sum over (bin, chunk) so every chunk gets its own write offset within each bin
+    //The bin counts are known here, so the occupancy bitmaps are filled along the way
+    occupancy.clear();
+    int offset = 0;
+    for (size_t g = 0; g < grid_count; g++)
+    {
+        const int first = offset;
+        int team_counts[2];
+        for (int team = BLUE; team <= RED; team++)
+        {
+            const int team_first = offset;
+            for (size_t c = 0; c < chunk_count; c++)
+            {
+                const int count = chunk_counters[c][g * 2 + team];
+                chunk_counters[c][g * 2 + team] = offset;
+                offset += count;
+            }
+            team_counts[team] = offset - team_first;
+            if (team_counts[team] > 0) occupancy.set((allignments)team, g);
+        }
+        grids[g].SetTankRange(first, team_counts[BLUE], team_counts[RED]);
+    }
+    grid_tanks.resize(offset);
+    occupancy.build_summary();
+
+    //Scatter the tank indices into the grid sorted array
+    run_partitioned(pool, chunks, [&](const Grid_range& chunk)
+    {
+        vector<int>& offsets = chunk_counters[&chunk - chunks.data()];
+        for (size_t i = chunk.begin; i < chunk.end; i++)
+        {
+            if (tank_bins[i] < 0) continue;
+            grid_tanks[offsets[tank_bins[i]]++] = (int)i;
+        }
+    });
+
+    //Refresh the grid flags, now weighted by the tanks per grid
+    run_partitioned(pool, Grid_partitioner::partition(grids, thread_count), [&](Grid_range range)
+    {
+        for (size_t g = range.begin; g < range.end; g++)
+        {
+            grids[g].UpdateFlags(tanks, grid_tanks);
+        }
+    });
+}
+
+} // namespace Tmpl8
@@ -0,0 +1,27 @@
+#pragma once
+
+class Grid;
+
+namespace Tmpl8
+{
+
+//Sorts all tanks into their grids with a parallel counting sort, no locks needed:
+// 1. every thread computes the bin (grid, team) of its tanks and counts them per bin in its own counters
+// 2. a prefix sum over (bin, thread) turns the counters into write offsets
+// 3. every thread scatters its tank indices into the flat grid sorted array
+//Sorting on team within a grid gives every grid a blue range followed by a red range
+//Tanks keep their relative order inside a bin, so the result doesn't depend on the thread schedule
+class Grid_rebinner
+{
+  public:
+    void rebin(const vector<Tank>& tanks, vector<Grid>& grids, vector<int>& grid_tanks, Occupancy_bitmap& occupancy, int grid_size, size_t grid_width, ThreadPool& pool, size_t thread_count);
+
+  private:
+    //Bin (grid * 2 + team) per tank, -1 for tanks that left the map
+    vector<int> tank_bins;
+
+    //Tank count (and after the prefix sum the write offset) per bin, one counter array per chunk of tanks
+    vector<vector<int>> chunk_counters;
+};
+
+} // namespace Tmpl8
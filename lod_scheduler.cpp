@@ -0,0 +1,17 @@
+#include "precomp.h"
+#include "lod_scheduler.h"
+
+namespace Tmpl8
+{
+
+int Lod_scheduler::tick_interval(float enemy_distance) const
+{
+    if (!settings.enabled || enemy_distance < settings.near_distance)
+    {
+        return 1;
+    }
+
+    return (enemy_distance < settings.far_distance) ? std::max(settings.mid_interval, 1) : std::max(settings.far_interval, 1);
+}
+
+} // namespace Tmpl8
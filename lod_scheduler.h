@@ -0,0 +1,39 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//Thresholds for the tank level of detail, distances are in pixels to the closest enemy grid
+struct Lod_settings
+{
+    bool enabled = true;
+
+    //Closer than this to an enemy ticks every frame
+    float near_distance = 192.f;
+    //Between near and far ticks every mid_interval frames, beyond far every far_interval frames
+    float far_distance = 384.f;
+
+    int mid_interval = 2;
+    int far_interval = 4;
+};
+
+//Decides how often tanks get ticked, full rate near combat and a reduced rate for units far away from it
+//Tanks on a reduced rate are spread over the frames of their interval and a tick moves them over all frames since
+//their last one, so switching intervals neither skips nor repeats movement
+class Lod_scheduler
+{
+  public:
+    void set_settings(const Lod_settings& settings) { this->settings = settings; }
+    const Lod_settings& get_settings() const { return settings; }
+
+    //Frames between ticks for a tank that is enemy_distance pixels away from the closest enemy grid
+    int tick_interval(float enemy_distance) const;
+
+    //Does the tank tick this frame, given its interval
+    static bool ticks_on(long long frame, int tank_handle, int interval) { return interval <= 1 || ((frame + tank_handle) % interval) == 0; }
+
+  private:
+    Lod_settings settings;
+};
+
+} // namespace Tmpl8
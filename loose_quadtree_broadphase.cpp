@@ -0,0 +1,114 @@
+#include "precomp.h"
+#include "loose_quadtree_broadphase.h"
+
+namespace Tmpl8
+{
+
+void Loose_quadtree_broadphase::build(const vector<Tank>& tanks, ThreadPool&, size_t)
+{
+    items.clear();
+    nodes.clear();
+    max_radius = 0.f;
+
+    for (size_t i = 0; i < tanks.size(); i++)
+    {
+        if (tanks[i].active == false) continue;
+
+        items.push_back((int)i);
+        max_radius = std::max(max_radius, tanks[i].collision_radius);
+    }
+
+    //Tanks outside of the world stay in the root, its loose bounds are never tested
+    const float half_size = std::max(world_size.x, world_size.y) * 0.5f;
+    nodes.push_back({world_size * 0.5f, half_size, 0, items.size(), items.size(), -1});
+    build_node(tanks, 0, 0);
+}
+
+void Loose_quadtree_broadphase::build_node(const vector<Tank>& tanks, int node, int depth)
+{
+    const Node n = nodes[node];
+    if (n.end - n.begin <= leaf_capacity || depth >= max_depth) return;
+
+    //A tank fits in a child if it is no larger than the child's slack of half the child size
+    const float child_half_size = n.half_size * 0.5f;
+    auto quadrant = [&tanks, &n, child_half_size](int tank)
+    {
+        const Tank& t = tanks[tank];
+        if (t.collision_radius > child_half_size) return -1;
+        if (std::abs(t.position.x - n.center.x) > n.half_size || std::abs(t.position.y - n.center.y) > n.half_size) return -1;
+        return ((t.position.x >= n.center.x) ? 1 : 0) + ((t.position.y >= n.center.y) ? 2 : 0);
+    };
+
+    //Stable partition, so the item order and with it the push order is deterministic
+    auto first = items.begin() + n.begin;
+    auto last = items.begin() + n.end;
+    auto own_end = std::stable_partition(first, last, [&quadrant](int tank) { return quadrant(tank) < 0; });
+
+    size_t begin = own_end - items.begin();
+    nodes[node].own_end = begin;
+    nodes[node].first_child = (int)nodes.size();
+
+    for (int q = 0; q < 4; q++)
+    {
+        auto child_end = std::stable_partition(items.begin() + begin, last, [&quadrant, q](int tank) { return quadrant(tank) == q; });
+        const size_t end = child_end - items.begin();
+
+        const vec2 offset = vec2((q & 1) ? child_half_size : -child_half_size, (q & 2) ? child_half_size : -child_half_size);
+        nodes.push_back({n.center + offset, child_half_size, begin, end, end, -1});
+        begin = end;
+    }
+
+    const int first_child = nodes[node].first_child;
+    for (int q = 0; q < 4; q++)
+    {
+        build_node(tanks, first_child + q, depth + 1);
+    }
+}
+
+void Loose_quadtree_broadphase::collide(vector<Tank>& tanks, ThreadPool& pool, size_t thread_count)
+{
+    run_partitioned(pool, Grid_partitioner::split_evenly(items.size(), thread_count), [this, &tanks](Grid_range range)
+    {
+        for (size_t i = range.begin; i < range.end; i++)
+        {
+            Tank& t = tanks[items[i]];
+            query(tanks, t, t.collision_radius + max_radius);
+        }
+    });
+}
+
+//Visits every node that can hold a tank within reach of the tank
+void Loose_quadtree_broadphase::query(vector<Tank>& tanks, Tank& t, float reach) const
+{
+    int stack[64];
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+
+    while (stack_size > 0)
+    {
+        const Node& n = nodes[stack[--stack_size]];
+
+        for (size_t i = n.begin; i < n.own_end; i++)
+        {
+            Tank& other = tanks[items[i]];
+            if (&other == &t) continue;
+            push_apart(t, other);
+        }
+
+        if (n.first_child < 0) continue;
+
+        for (int q = 0; q < 4; q++)
+        {
+            const Node& child = nodes[n.first_child + q];
+            if (child.begin == child.end) continue;
+
+            //The centers of the child's tanks lie within its tight bounds, so those are enough to test against
+            if (std::abs(t.position.x - child.center.x) <= child.half_size + reach && std::abs(t.position.y - child.center.y) <= child.half_size + reach)
+            {
+                stack[stack_size++] = n.first_child + q;
+            }
+        }
+    }
+}
+
+} // namespace Tmpl8
@@ -0,0 +1,48 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//Quadtree that only splits where many tanks are, so it adapts to tanks clumping together and to large empty maps
+//A node's loose bounds are twice its size, a tank goes into the deepest node that contains its center and whose
+//loose bounds contain the whole tank, so every tank is stored exactly once
+//Nodes own a contiguous range of the item array: first their own tanks, then the ranges of their children
+class Loose_quadtree_broadphase : public Broadphase
+{
+  public:
+    Loose_quadtree_broadphase(vec2 world_size, size_t leaf_capacity = 16, int max_depth = 8)
+        : world_size(world_size), leaf_capacity(leaf_capacity), max_depth(max_depth) {}
+
+    const char* get_name() const override { return "loose quadtree"; }
+
+    void build(const vector<Tank>& tanks, ThreadPool& pool, size_t thread_count) override;
+    void collide(vector<Tank>& tanks, ThreadPool& pool, size_t thread_count) override;
+
+  private:
+    struct Node
+    {
+        vec2 center;
+        float half_size;
+
+        //Own tanks are items[begin, own_end), the children follow up to end
+        size_t begin;
+        size_t own_end;
+        size_t end;
+
+        //Index of the first of 4 children, -1 for a leaf
+        int first_child;
+    };
+
+    void build_node(const vector<Tank>& tanks, int node, int depth);
+    void query(vector<Tank>& tanks, Tank& t, float reach) const;
+
+    vec2 world_size;
+    size_t leaf_capacity;
+    int max_depth;
+
+    vector<Node> nodes;
+    vector<int> items;
+    float max_radius = 0.f;
+};
+
+} // namespace Tmpl8
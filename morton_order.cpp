@@ -0,0 +1,46 @@
+#include "precomp.h"
+#include "morton_order.h"
+
+namespace Tmpl8
+{
+
+void Morton_order::reorder(vector<Tank>& tanks, vector<int>& tank_slots, vector<int>& tank_handles, float cell_size, ThreadPool& pool, size_t thread_count)
+{
+    keys.resize(tanks.size());
+
+    run_partitioned(pool, Grid_partitioner::split_evenly(tanks.size(), thread_count), [this, &tanks, cell_size](Grid_range range)
+    {
+        for (size_t i = range.begin; i < range.end; i++)
+        {
+            const Tank& t = tanks[i];
+
+            //Tanks off the map are clamped onto its border
+            const uint32_t x = (uint32_t)clamp(t.position.x / cell_size, 0.f, 65535.f);
+            const uint32_t y = (uint32_t)clamp(t.position.y / cell_size, 0.f, 65535.f);
+
+            const uint64_t team = (uint64_t)t.allignment << 33;
+            const uint64_t destroyed = (uint64_t)(t.active ? 0 : 1) << 32;
+            keys[i] = {team | destroyed | morton_code(x, y), (int)i};
+        }
+    });
+
+    //Stable, so tanks in the same cell keep their order and the result is deterministic
+    std::stable_sort(keys.begin(), keys.end(), [](const Sort_key& a, const Sort_key& b) { return a.key < b.key; });
+
+    sorted_tanks.clear();
+    sorted_tanks.reserve(tanks.size());
+    sorted_handles.resize(tanks.size());
+
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        const int slot = keys[i].slot;
+        sorted_tanks.push_back(std::move(tanks[slot]));
+        sorted_handles[i] = tank_handles[slot];
+        tank_slots[tank_handles[slot]] = (int)i;
+    }
+
+    tanks.swap(sorted_tanks);
+    tank_handles.swap(sorted_handles);
+}
+
+} // namespace Tmpl8
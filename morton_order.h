@@ -0,0 +1,43 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//Spreads the lower 16 bits of value over the even bits
+inline uint32_t spread_bits(uint32_t value)
+{
+    value &= 0x0000ffff;
+    value = (value | (value << 8)) & 0x00ff00ff;
+    value = (value | (value << 4)) & 0x0f0f0f0f;
+    value = (value | (value << 2)) & 0x33333333;
+    value = (value | (value << 1)) & 0x55555555;
+    return value;
+}
+
+//Position on the Z-curve, cells that are close on the map are mostly close on the curve
+inline uint32_t morton_code(uint32_t x, uint32_t y)
+{
+    return spread_bits(x) | (spread_bits(y) << 1);
+}
+
+//Reorders the tank storage along the Z-curve of their grid cells, so tanks that are neighbours on the map
+//are neighbours in memory too. Teams stay in separate ranges (blue first) and destroyed tanks move to the end of
+//their team range. Tanks are referred to by a handle that stays the same, the handle to slot table is updated here
+class Morton_order
+{
+  public:
+    void reorder(vector<Tank>& tanks, vector<int>& tank_slots, vector<int>& tank_handles, float cell_size, ThreadPool& pool, size_t thread_count);
+
+  private:
+    struct Sort_key
+    {
+        uint64_t key;
+        int slot;
+    };
+
+    vector<Sort_key> keys;
+    vector<Tank> sorted_tanks;
+    vector<int> sorted_handles;
+};
+
+} // namespace Tmpl8
@@ -0,0 +1,90 @@
+#include "precomp.h"
+#include "occupancy_bitmap.h"
+
+namespace Tmpl8
+{
+
+void Occupancy_bitmap::resize(size_t grid_width, size_t grid_height)
+{
+    this->grid_width = grid_width;
+    this->grid_height = grid_height;
+    this->grid_count = grid_width * grid_height;
+
+    blocks_x = (grid_width + block_size - 1) / block_size;
+    blocks_y = (grid_height + block_size - 1) / block_size;
+
+    const size_t words = (grid_count + 63) / 64;
+    const size_t block_words = (blocks_x * blocks_y + 63) / 64;
+    for (int team = BLUE; team <= RED; team++)
+    {
+        bits[team].assign(words, 0);
+        block_bits[team].assign(block_words, 0);
+    }
+    occupied.assign(words, 0);
+    occupied_blocks.assign(block_words, 0);
+}
+
+void Occupancy_bitmap::clear()
+{
+    for (int team = BLUE; team <= RED; team++)
+    {
+        std::fill(bits[team].begin(), bits[team].end(), 0);
+        std::fill(block_bits[team].begin(), block_bits[team].end(), 0);
+    }
+    std::fill(occupied.begin(), occupied.end(), 0);
+    std::fill(occupied_blocks.begin(), occupied_blocks.end(), 0);
+}
+
+void Occupancy_bitmap::set(allignments team, size_t grid_index)
+{
+    const uint64_t bit = 1ull << (grid_index & 63);
+    bits[team][grid_index >> 6] |= bit;
+    occupied[grid_index >> 6] |= bit;
+}
+
+size_t Occupancy_bitmap::count(allignments team) const
+{
+    size_t total = 0;
+    for (uint64_t word : bits[team])
+    {
+        total += count_bits(word);
+    }
+    return total;
+}
+
+void Occupancy_bitmap::build_summary()
+{
+    for (int team = BLUE; team <= RED; team++)
+    {
+        std::fill(block_bits[team].begin(), block_bits[team].end(), 0);
+
+        //A block is occupied when any grid in it is
+        for_each_bit(bits[team], 0, grid_count, [this, team](size_t grid_index)
+        {
+            const size_t block = (grid_index / grid_width / block_size) * blocks_x + (grid_index % grid_width) / block_size;
+            block_bits[team][block >> 6] |= 1ull << (block & 63);
+        });
+    }
+
+    for (size_t w = 0; w < occupied_blocks.size(); w++)
+    {
+        occupied_blocks[w] = block_bits[BLUE][w] | block_bits[RED][w];
+    }
+}
+
+uint64_t Occupancy_bitmap::row_bits(const vector<uint64_t>& words, size_t x, size_t y, size_t count) const
+{
+    const size_t first = y * grid_width + x;
+    const size_t word = first >> 6;
+    const size_t shift = first & 63;
+
+    //The row may straddle two words
+    uint64_t result = words[word] >> shift;
+    if (shift + count > 64 && word + 1 < words.size())
+    {
+        result |= words[word + 1] << (64 - shift);
+    }
+    return result & ((1ull << count) - 1);
+}
+
+} // namespace Tmpl8
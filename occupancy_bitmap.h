@@ -0,0 +1,128 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//Index of the lowest set bit, bits must not be 0
+inline int lowest_bit(uint64_t bits)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+inline int count_bits(uint64_t bits)
+{
+#ifdef _MSC_VER
+    return (int)__popcnt64(bits);
+#else
+    return __builtin_popcountll(bits);
+#endif
+}
+
+//One bit per grid per team, so finding occupied grids scans a few hundred bytes instead of all Grid objects
+//A summary level keeps one bit per block of 8x8 grids, to skip large empty regions at once
+class Occupancy_bitmap
+{
+  public:
+    static constexpr size_t block_size = 8;
+
+    void resize(size_t grid_width, size_t grid_height);
+    void clear();
+
+    void set(allignments team, size_t grid_index);
+    bool test(allignments team, size_t grid_index) const { return (bits[team][grid_index >> 6] >> (grid_index & 63)) & 1; }
+    size_t count(allignments team) const;
+
+    //Rebuild the block summary from the grid bits, call after setting all grids
+    void build_summary();
+
+    //Calls func(grid_index) for every grid with tanks of the team, in grid order
+    template <typename Func>
+    void for_each(allignments team, Func func) const { for_each_in_blocks(bits[team], block_bits[team], func); }
+
+    //Calls func(grid_index) for every grid with tanks of any team (optionally only within [begin, end)), in grid order
+    template <typename Func>
+    void for_each_occupied(Func func) const { for_each_in_blocks(occupied, occupied_blocks, func); }
+    template <typename Func>
+    void for_each_occupied(size_t begin, size_t end, Func func) const { for_each_bit(occupied, begin, end, func); }
+
+  private:
+    template <typename Func>
+    static void for_each_bit(const vector<uint64_t>& words, size_t begin, size_t end, Func func);
+
+    //for_each_bit over the whole map that only reads the grid rows of the occupied blocks
+    template <typename Func>
+    void for_each_in_blocks(const vector<uint64_t>& words, const vector<uint64_t>& blocks, Func func) const;
+
+    //The (at most 8) bits of the grids [x, x + count) of row y
+    uint64_t row_bits(const vector<uint64_t>& words, size_t x, size_t y, size_t count) const;
+
+    size_t grid_width = 0;
+    size_t grid_height = 0;
+    size_t grid_count = 0;
+
+    size_t blocks_x = 0;
+    size_t blocks_y = 0;
+
+    vector<uint64_t> bits[2];
+    vector<uint64_t> occupied;
+    vector<uint64_t> block_bits[2];
+    vector<uint64_t> occupied_blocks;
+};
+
+template <typename Func>
+void Occupancy_bitmap::for_each_in_blocks(const vector<uint64_t>& words, const vector<uint64_t>& blocks, Func func) const
+{
+    for (size_t block_y = 0; block_y < blocks_y; block_y++)
+    {
+        const size_t first_block = block_y * blocks_x;
+        const size_t first_y = block_y * block_size;
+        const size_t last_y = std::min(first_y + block_size, grid_height);
+
+        //Row by row through the occupied blocks of this block row, so the grids still come in grid order
+        for (size_t y = first_y; y < last_y; y++)
+        {
+            for_each_bit(blocks, first_block, first_block + blocks_x, [&](size_t block)
+            {
+                const size_t first_x = (block - first_block) * block_size;
+                uint64_t row = row_bits(words, first_x, y, std::min(block_size, grid_width - first_x));
+                while (row != 0)
+                {
+                    func(y * grid_width + first_x + lowest_bit(row));
+                    row &= row - 1;
+                }
+            });
+        }
+    }
+}
+
+template <typename Func>
+void Occupancy_bitmap::for_each_bit(const vector<uint64_t>& words, size_t begin, size_t end, Func func)
+{
+    if (begin >= end) return;
+
+    const size_t first_word = begin >> 6;
+    const size_t last_word = (end - 1) >> 6;
+
+    for (size_t w = first_word; w <= last_word; w++)
+    {
+        uint64_t word = words[w];
+
+        //Mask off the bits outside of [begin, end)
+        if (w == first_word) word &= ~0ull << (begin & 63);
+        if (w == last_word && (end & 63) != 0) word &= ~0ull >> (64 - (end & 63));
+
+        while (word != 0)
+        {
+            func((w << 6) + lowest_bit(word));
+            word &= word - 1;
+        }
+    }
+}
+
+} // namespace Tmpl8
@@ -4,11 +4,11 @@
 namespace Tmpl8
 {
 
-Particle_beam::Particle_beam() : min_position(), max_position(), particle_beam_sprite(nullptr), sprite_frame(0), rectangle(), damage(1)
+Particle_beam::Particle_beam() : min_position(), max_position(), particle_beam_sprite(nullptr), start_frame(0), rectangle(), damage(1)
 {
 }
 
-Particle_beam::Particle_beam(vec2 min, vec2 max, Sprite* particle_beam_sprite, int damage) : particle_beam_sprite(particle_beam_sprite), sprite_frame(0), damage(damage)
+Particle_beam::Particle_beam(vec2 min, vec2 max, Sprite* particle_beam_sprite, int damage, long long start_frame) : particle_beam_sprite(particle_beam_sprite), start_frame(start_frame), damage(damage)
 {
     min_position = min;
     max_position = min + max;
@@ -16,24 +16,14 @@ Particle_beam::Particle_beam(vec2 min, vec2 max, Sprite* particle_beam_sprite, i
     rectangle = Rectangle2D(min_position, max_position);
 }
 
-void Particle_beam::tick(vector<Tank>& tanks)
-{
-
-    if (++sprite_frame == 30)
-    {
-        sprite_frame = 0;
-    }
-}
-
-void Particle_beam::draw(Surface* screen)
+void Particle_beam::draw(Render_buffer& buffer, long long frame) const
 {
     vec2 position = rectangle.min;
 
     const int offset_x = 23;
     const int offset_y = 137;
 
-    particle_beam_sprite->set_frame(sprite_frame / 10);
-    particle_beam_sprite->draw(screen, (int)(position.x - offset_x + HEALTHBAR_OFFSET), (int)(position.y - offset_y));
+    buffer.push(PARTICLE_BEAM_LAYER, particle_beam_sprite, get_animation(PARTICLE_BEAM_ANIMATION).sprite_frame(start_frame, frame), (int)(position.x - offset_x + HEALTHBAR_OFFSET), (int)(position.y - offset_y));
 }
 
 } // namespace Tmpl8
\ No newline at end of file
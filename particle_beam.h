@@ -6,20 +6,19 @@ class Particle_beam
 {
   public:
     Particle_beam();
-    Particle_beam(vec2 min, vec2 max, Sprite* particle_beam_sprite, int damage);
+    Particle_beam(vec2 min, vec2 max, Sprite* particle_beam_sprite, int damage, long long start_frame);
 
-    void tick(vector<Tank>& tanks);
-    void draw(Surface* screen);
+    void draw(Render_buffer& buffer, long long frame) const;
 
     vec2 min_position;
     vec2 max_position;
 
     Rectangle2D rectangle;
 
-    int sprite_frame;
+    long long start_frame;
 
     int damage;
 
-    Sprite* particle_beam_sprite;
+    const Sprite* particle_beam_sprite;
 };
 } // namespace Tmpl8
\ No newline at end of file
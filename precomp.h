@@ -47,6 +47,7 @@
 #include <sstream>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <random>
 #include <string>
 #include <vector>
@@ -83,16 +84,35 @@ using namespace Tmpl8;
 
 #include "thread_pool.h"
 
+#include "animation.h"
+#include "render_buffer.h"
 #include "tank.h"
 #include "terrain.h"
-#include "rocket.h"
+#include "rocket_pool.h"
+#include "rocket_collider.h"
+#include "effect_pool.h"
 #include "smoke.h"
 #include "explosion.h"
 #include "particle_beam.h"
+#include "occupancy_bitmap.h"
+#include "distance_field.h"
+#include "timer_wheel.h"
+#include "rocket_scheduler.h"
+#include "lod_scheduler.h"
+#include "cell_size_tuner.h"
+#include "morton_order.h"
+#include "broadphase.h"
+#include "uniform_grid_broadphase.h"
+#include "sort_and_sweep_broadphase.h"
+#include "loose_quadtree_broadphase.h"
+#include "grid_rebinner.h"
+#include "forcefield_hull.h"
+#include "beam_index.h"
 
 #include "game.h"
 
 // clang-format on
 
 // reference additional headers your program requires here
-#include "Grid.h"
\ No newline at end of file
+#include "Grid.h"
+#include "grid_partitioner.h"
\ No newline at end of file
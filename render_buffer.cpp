@@ -0,0 +1,74 @@
+#include "precomp.h"
+#include "render_buffer.h"
+
+namespace Tmpl8
+{
+
+void Render_buffer::push(Render_layer layer, const Sprite* sprite, int frame, int x, int y)
+{
+    const uint32_t row = (uint32_t)clamp(y, 0, (1 << row_bits) - 1);
+    const uint16_t index = sprite_index(sprite);
+    const uint32_t key = ((uint32_t)layer << (sprite_bits + row_bits)) | ((uint32_t)index << row_bits) | row;
+
+    commands.push_back({key, index, (uint16_t)frame, x, y});
+}
+
+//Draws come in runs of the same sprite, so remembering the last one makes the lookup free most of the time
+uint16_t Render_buffer::sprite_index(const Sprite* sprite)
+{
+    if (sprite == last_sprite) return last_index;
+
+    auto found = std::find(sprites.begin(), sprites.end(), sprite);
+    if (found == sprites.end())
+    {
+        assert(sprites.size() < (1 << sprite_bits));
+        sprites.push_back(sprite);
+        found = sprites.end() - 1;
+    }
+
+    last_sprite = sprite;
+    last_index = (uint16_t)(found - sprites.begin());
+    return last_index;
+}
+
+void Render_buffer::sort()
+{
+    constexpr int key_bits = row_bits + sprite_bits + layer_bits;
+    constexpr uint32_t digit_mask = (1u << digit_bits) - 1;
+
+    vector<size_t> offsets(size_t(1) << digit_bits);
+    sorted.resize(commands.size());
+
+    for (int shift = 0; shift < key_bits; shift += digit_bits)
+    {
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (const Command& command : commands)
+        {
+            offsets[(command.key >> shift) & digit_mask]++;
+        }
+
+        size_t sum = 0;
+        for (size_t& offset : offsets)
+        {
+            const size_t count = offset;
+            offset = sum;
+            sum += count;
+        }
+
+        for (const Command& command : commands)
+        {
+            sorted[offsets[(command.key >> shift) & digit_mask]++] = command;
+        }
+        commands.swap(sorted);
+    }
+}
+
+void Render_buffer::submit(Surface* target) const
+{
+    for (const Command& command : commands)
+    {
+        sprites[command.sprite]->draw(target, command.x, command.y, command.frame);
+    }
+}
+
+} // namespace Tmpl8
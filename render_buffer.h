@@ -0,0 +1,63 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//Draw order of the sprite layers, everything on a layer is drawn before the next layer starts
+enum Render_layer
+{
+    DECAL_LAYER,
+    TANK_LAYER,
+    ROCKET_LAYER,
+    SMOKE_LAYER,
+    PARTICLE_BEAM_LAYER,
+    EXPLOSION_LAYER,
+    LAYER_COUNT
+};
+
+//Collects the sprite draws of a frame as small commands and draws them sorted instead of in the order they came in
+//Within a layer the commands are grouped by sprite sheet and then ordered by destination row, so the source pixels
+//of one sheet stay in cache while it is drawn and the rows written after each other are close together
+class Render_buffer
+{
+  public:
+    void clear() { commands.clear(); }
+
+    void push(Render_layer layer, const Sprite* sprite, int frame, int x, int y);
+
+    //Radix sort on layer, sprite and row, the order of equal keys is kept
+    void sort();
+
+    //Draw all commands in their current order
+    void submit(Surface* target) const;
+
+    size_t size() const { return commands.size(); }
+
+  private:
+    static constexpr int row_bits = 11;
+    static constexpr int sprite_bits = 5;
+    static constexpr int layer_bits = 3;
+    static constexpr int digit_bits = 11;
+    static_assert(LAYER_COUNT <= (1 << layer_bits), "Render layers don't fit in the sort key");
+
+    struct Command
+    {
+        uint32_t key;
+        uint16_t sprite;
+        uint16_t frame;
+        int x;
+        int y;
+    };
+
+    uint16_t sprite_index(const Sprite* sprite);
+
+    vector<Command> commands;
+    vector<Command> sorted;
+
+    //Index in this list is the sprite id in the sort key
+    vector<const Sprite*> sprites;
+    const Sprite* last_sprite = nullptr;
+    uint16_t last_index = 0;
+};
+
+} // namespace Tmpl8
@@ -0,0 +1,333 @@
+#include "precomp.h"
+#include "rocket_collider.h"
+
+namespace Tmpl8
+{
+
+void Rocket_collider::Candidates::clear()
+{
+    x.clear();
+    y.clear();
+    radius.clear();
+    tank.clear();
+}
+
+void Rocket_collider::collide(const Rocket_pool& rockets, const vector<int>& checked_rockets, vector<Tank>& tanks, const vector<Grid>& grids, const vector<int>& grid_tanks, int grid_size, size_t grid_width, size_t grid_height, int hit_value, vector<Rocket_hit>& hits)
+{
+    hits.clear();
+    if (checked_rockets.empty()) return;
+
+    const float rocket_radius = rockets.get_collision_radius();
+    const int width = (int)grid_width;
+    const int height = (int)grid_height;
+
+    auto grid_of = [grid_size](vec2 position) { return vec2(std::floor(position.x / grid_size), std::floor(position.y / grid_size)); };
+    auto on_map = [width, height](int x, int y) { return x >= 0 && y >= 0 && x < width && y < height; };
+
+    rockets.get_positions(rocket_x, rocket_y);
+    auto position_of = [this](int rocket) { return vec2(rocket_x[rocket], rocket_y[rocket]); };
+
+    //Counting sort of the rockets that stayed in one grid on (grid, team)
+    const size_t bin_count = grids.size() * 2;
+    rocket_bins.resize(checked_rockets.size());
+    bin_start.assign(bin_count + 1, 0);
+    crossing_rockets.clear();
+
+    for (size_t i = 0; i < checked_rockets.size(); i++)
+    {
+        const int r = checked_rockets[i];
+        const vec2 end = grid_of(position_of(r));
+        const vec2 start = grid_of(position_of(r) - rockets.get_speed(r));
+
+        //Rockets just off the map can still hit tanks at the edge, the walk handles those
+        int bin = -1;
+        if (start.x == end.x && start.y == end.y && on_map((int)end.x, (int)end.y))
+        {
+            bin = ((int)end.y * width + (int)end.x) * 2 + rockets.get_allignment(r);
+            bin_start[bin + 1]++;
+        }
+        else
+        {
+            crossing_rockets.push_back(r);
+        }
+        rocket_bins[i] = bin;
+    }
+
+    for (size_t b = 0; b < bin_count; b++)
+    {
+        bin_start[b + 1] += bin_start[b];
+    }
+
+    binned_rockets.resize(bin_start[bin_count]);
+    {
+        vector<int> write_offset(bin_start.begin(), bin_start.end() - 1);
+        for (size_t i = 0; i < checked_rockets.size(); i++)
+        {
+            if (rocket_bins[i] >= 0) binned_rockets[write_offset[rocket_bins[i]]++] = checked_rockets[i];
+        }
+    }
+
+    for (size_t bin = 0; bin < bin_count; bin++)
+    {
+        if (bin_start[bin] == bin_start[bin + 1]) continue;
+
+        const size_t grid_index = bin / 2;
+        const allignments enemy = enemy_of((allignments)(bin % 2));
+        const int grid_x = (int)(grid_index % grid_width);
+        const int grid_y = (int)(grid_index / grid_width);
+
+        //Gather the active enemy tanks of the 3x3 grids around this one
+        candidates.clear();
+        for (int y = std::max(grid_y - 1, 0); y <= std::min(grid_y + 1, height - 1); y++)
+        {
+            for (int x = std::max(grid_x - 1, 0); x <= std::min(grid_x + 1, width - 1); x++)
+            {
+                gather(tanks, grids[y * grid_width + x], enemy, grid_tanks);
+            }
+        }
+
+        if (candidates.tank.empty()) continue;
+
+        for (int i = bin_start[bin]; i < bin_start[bin + 1]; i++)
+        {
+            const int rocket = binned_rockets[i];
+            const vec2 speed = rockets.get_speed(rocket);
+            const int candidate = first_hit(candidates, position_of(rocket) - speed, speed, rocket_radius);
+            if (candidate >= 0) apply_hit(tanks, rocket, candidate, hit_value, hits);
+        }
+    }
+
+    //Walk the grids along the path of every rocket that crossed a grid border (Amanatides & Woo)
+    gathered_by.assign(grids.size(), -1);
+    for (int rocket : crossing_rockets)
+    {
+        const allignments enemy = enemy_of(rockets.get_allignment(rocket));
+        const vec2 speed = rockets.get_speed(rocket);
+        const vec2 start = position_of(rocket) - speed;
+        const vec2 start_grid = grid_of(start);
+        const vec2 end_grid = grid_of(position_of(rocket));
+
+        int x = (int)start_grid.x;
+        int y = (int)start_grid.y;
+        const int step_x = (speed.x > 0) ? 1 : -1;
+        const int step_y = (speed.y > 0) ? 1 : -1;
+
+        const float infinity = numeric_limits<float>::infinity();
+        float next_x = (speed.x != 0) ? (((x + (step_x > 0 ? 1 : 0)) * grid_size) - start.x) / speed.x : infinity;
+        float next_y = (speed.y != 0) ? (((y + (step_y > 0 ? 1 : 0)) * grid_size) - start.y) / speed.y : infinity;
+        const float delta_x = (speed.x != 0) ? grid_size / std::abs(speed.x) : infinity;
+        const float delta_y = (speed.y != 0) ? grid_size / std::abs(speed.y) : infinity;
+
+        //Every step moves one grid towards the end, so this also bounds the walk against rounding
+        int steps = std::abs((int)end_grid.x - x) + std::abs((int)end_grid.y - y);
+
+        //Gathers the 3x3 grids around a grid on the path, skipping grids this rocket gathered already
+        auto gather_around = [&](int grid_x, int grid_y)
+        {
+            for (int ny = std::max(grid_y - 1, 0); ny <= std::min(grid_y + 1, height - 1); ny++)
+            {
+                for (int nx = std::max(grid_x - 1, 0); nx <= std::min(grid_x + 1, width - 1); nx++)
+                {
+                    const int neighbour = ny * width + nx;
+                    if (gathered_by[neighbour] == rocket) continue;
+
+                    gathered_by[neighbour] = rocket;
+                    gather(tanks, grids[neighbour], enemy, grid_tanks);
+                }
+            }
+        };
+
+        candidates.clear();
+        while (true)
+        {
+            gather_around(x, y);
+
+            if (steps-- == 0) break;
+
+            if (next_x < next_y)
+            {
+                x += step_x;
+                next_x += delta_x;
+            }
+            else
+            {
+                y += step_y;
+                next_y += delta_y;
+            }
+        }
+
+        //Rounding can make the walk end next to the end grid, make sure that one is gathered too
+        if (x != (int)end_grid.x || y != (int)end_grid.y)
+        {
+            gather_around((int)end_grid.x, (int)end_grid.y);
+        }
+
+        const int candidate = first_hit(candidates, start, speed, rocket_radius);
+        if (candidate >= 0) apply_hit(tanks, rocket, candidate, hit_value, hits);
+    }
+
+    std::sort(hits.begin(), hits.end(), [](const Rocket_hit& a, const Rocket_hit& b) { return a.rocket < b.rocket; });
+}
+
+void Rocket_collider::gather(vector<Tank>& tanks, const Grid& grid, allignments team, const vector<int>& grid_tanks)
+{
+    for (Tank& t : grid.GetTeamTanks(team, tanks, grid_tanks))
+    {
+        if (t.active == false) continue;
+
+        candidates.x.push_back(t.position.x);
+        candidates.y.push_back(t.position.y);
+        candidates.radius.push_back(t.collision_radius);
+        candidates.tank.push_back((int)(&t - tanks.data()));
+    }
+}
+
+void Rocket_collider::apply_hit(vector<Tank>& tanks, int rocket, int candidate, int hit_value, vector<Rocket_hit>& hits)
+{
+    const int tank = candidates.tank[candidate];
+    const bool destroyed = tanks[tank].hit(hit_value);
+    hits.push_back({rocket, tank, destroyed});
+
+    //A NaN position never gets hit, so the destroyed tank drops out of the candidates
+    if (destroyed) candidates.x[candidate] = numeric_limits<float>::quiet_NaN();
+}
+
+//Per candidate the time (0 at start, 1 at the end of the motion) at which the circles touch, from
+//|start + t * motion - center| = radius sum, already touching at the start is time 0
+//8 candidates per step with AVX2, then 4 with SSE2, then one by one. Ties go to the lowest index
+int Rocket_collider::first_hit(const Candidates& candidates, vec2 start, vec2 motion, float radius)
+{
+    const size_t count = candidates.x.size();
+    const float* xs = candidates.x.data();
+    const float* ys = candidates.y.data();
+    const float* radii = candidates.radius.data();
+
+    //A non moving rocket has a = 0, the division then gives NaN and only the touching at the start test can hit
+    const float a = motion.x * motion.x + motion.y * motion.y;
+
+    int best = -1;
+    float best_time = numeric_limits<float>::infinity();
+    size_t i = 0;
+
+#ifdef __AVX2__
+    {
+        const __m256 start_x8 = _mm256_set1_ps(start.x);
+        const __m256 start_y8 = _mm256_set1_ps(start.y);
+        const __m256 motion_x8 = _mm256_set1_ps(motion.x);
+        const __m256 motion_y8 = _mm256_set1_ps(motion.y);
+        const __m256 radius8 = _mm256_set1_ps(radius);
+        const __m256 a8 = _mm256_set1_ps(a);
+        const __m256 zero8 = _mm256_setzero_ps();
+        const __m256 one8 = _mm256_set1_ps(1.f);
+        const __m256 infinity8 = _mm256_set1_ps(numeric_limits<float>::infinity());
+
+        alignas(32) float times[8];
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 fx = _mm256_sub_ps(start_x8, _mm256_loadu_ps(xs + i));
+            const __m256 fy = _mm256_sub_ps(start_y8, _mm256_loadu_ps(ys + i));
+            const __m256 r = _mm256_add_ps(_mm256_loadu_ps(radii + i), radius8);
+
+            const __m256 half_b = _mm256_add_ps(_mm256_mul_ps(fx, motion_x8), _mm256_mul_ps(fy, motion_y8));
+            const __m256 c = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(fx, fx), _mm256_mul_ps(fy, fy)), _mm256_mul_ps(r, r));
+            const __m256 discriminant = _mm256_sub_ps(_mm256_mul_ps(half_b, half_b), _mm256_mul_ps(a8, c));
+
+            const __m256 root = _mm256_sqrt_ps(_mm256_max_ps(discriminant, zero8));
+            const __m256 t = _mm256_div_ps(_mm256_sub_ps(_mm256_sub_ps(zero8, half_b), root), a8);
+
+            const __m256 touching = _mm256_cmp_ps(c, zero8, _CMP_LE_OQ);
+            const __m256 crossing = _mm256_and_ps(_mm256_cmp_ps(discriminant, zero8, _CMP_GE_OQ), _mm256_and_ps(_mm256_cmp_ps(t, zero8, _CMP_GE_OQ), _mm256_cmp_ps(t, one8, _CMP_LE_OQ)));
+
+            const __m256 time = _mm256_blendv_ps(_mm256_blendv_ps(infinity8, t, crossing), zero8, touching);
+            if (_mm256_movemask_ps(_mm256_cmp_ps(time, infinity8, _CMP_LT_OQ)) == 0) continue;
+
+            _mm256_store_ps(times, time);
+            for (int lane = 0; lane < 8; lane++)
+            {
+                if (times[lane] < best_time)
+                {
+                    best_time = times[lane];
+                    best = (int)i + lane;
+                }
+            }
+        }
+    }
+#endif
+
+    {
+        const __m128 start_x4 = _mm_set1_ps(start.x);
+        const __m128 start_y4 = _mm_set1_ps(start.y);
+        const __m128 motion_x4 = _mm_set1_ps(motion.x);
+        const __m128 motion_y4 = _mm_set1_ps(motion.y);
+        const __m128 radius4 = _mm_set1_ps(radius);
+        const __m128 a4 = _mm_set1_ps(a);
+        const __m128 zero4 = _mm_setzero_ps();
+        const __m128 one4 = _mm_set1_ps(1.f);
+        const __m128 infinity4 = _mm_set1_ps(numeric_limits<float>::infinity());
+
+        alignas(16) float times[4];
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 fx = _mm_sub_ps(start_x4, _mm_loadu_ps(xs + i));
+            const __m128 fy = _mm_sub_ps(start_y4, _mm_loadu_ps(ys + i));
+            const __m128 r = _mm_add_ps(_mm_loadu_ps(radii + i), radius4);
+
+            const __m128 half_b = _mm_add_ps(_mm_mul_ps(fx, motion_x4), _mm_mul_ps(fy, motion_y4));
+            const __m128 c = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(fx, fx), _mm_mul_ps(fy, fy)), _mm_mul_ps(r, r));
+            const __m128 discriminant = _mm_sub_ps(_mm_mul_ps(half_b, half_b), _mm_mul_ps(a4, c));
+
+            const __m128 root = _mm_sqrt_ps(_mm_max_ps(discriminant, zero4));
+            const __m128 t = _mm_div_ps(_mm_sub_ps(_mm_sub_ps(zero4, half_b), root), a4);
+
+            //SSE2 has no blend, select with and/andnot
+            const __m128 touching = _mm_cmple_ps(c, zero4);
+            const __m128 crossing = _mm_and_ps(_mm_cmpge_ps(discriminant, zero4), _mm_and_ps(_mm_cmpge_ps(t, zero4), _mm_cmple_ps(t, one4)));
+
+            __m128 time = _mm_or_ps(_mm_and_ps(crossing, t), _mm_andnot_ps(crossing, infinity4));
+            time = _mm_andnot_ps(touching, time);
+            if (_mm_movemask_ps(_mm_cmplt_ps(time, infinity4)) == 0) continue;
+
+            _mm_store_ps(times, time);
+            for (int lane = 0; lane < 4; lane++)
+            {
+                if (times[lane] < best_time)
+                {
+                    best_time = times[lane];
+                    best = (int)i + lane;
+                }
+            }
+        }
+    }
+
+    for (; i < count; i++)
+    {
+        const float fx = start.x - xs[i];
+        const float fy = start.y - ys[i];
+        const float r = radii[i] + radius;
+
+        const float half_b = fx * motion.x + fy * motion.y;
+        const float c = fx * fx + fy * fy - r * r;
+        const float discriminant = half_b * half_b - a * c;
+
+        float time = numeric_limits<float>::infinity();
+        if (c <= 0)
+        {
+            time = 0.f;
+        }
+        else if (discriminant >= 0)
+        {
+            const float t = (-half_b - std::sqrt(discriminant)) / a;
+            if (t >= 0 && t <= 1) time = t;
+        }
+
+        if (time < best_time)
+        {
+            best_time = time;
+            best = (int)i;
+        }
+    }
+
+    return best;
+}
+
+} // namespace Tmpl8
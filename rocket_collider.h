@@ -0,0 +1,63 @@
+#pragma once
+
+class Grid;
+
+namespace Tmpl8
+{
+
+struct Rocket_hit
+{
+    int rocket;
+    int tank;
+    bool destroyed;
+};
+
+//Rocket against tank hits, swept over the path the rocket moved this frame so fast rockets can't pass through tanks.
+//Most rockets stay within one grid during a frame: those are binned into the tank grids (per team), and the rockets
+//of a bin are tested against the enemy tanks of that grid and the 8 grids around it, gathered once into flat arrays
+//so the tests run 8 tanks at a time. Rockets that crossed a grid border (or are off the map) walk the grids along
+//their path instead (DDA).
+//Needs grids of at least rocket radius + tank radius, then a hit can never be more than one grid away from the path
+class Rocket_collider
+{
+  public:
+    //Damages the first enemy tank each of the checked rockets (indices into rockets) runs into and reports the hits
+    //sorted on rocket index. Hits are applied one after the other, so a tank destroyed by one rocket isn't hit by the next
+    void collide(const Rocket_pool& rockets, const vector<int>& checked_rockets, vector<Tank>& tanks, const vector<Grid>& grids, const vector<int>& grid_tanks, int grid_size, size_t grid_width, size_t grid_height, int hit_value, vector<Rocket_hit>& hits);
+
+  private:
+    //Enemy tanks near a bin or the path of a rocket
+    struct Candidates
+    {
+        vector<float> x;
+        vector<float> y;
+        vector<float> radius;
+        vector<int> tank;
+
+        void clear();
+    };
+
+    //Candidate the circle moving from start to start + motion touches first, -1 if it touches none
+    static int first_hit(const Candidates& candidates, vec2 start, vec2 motion, float radius);
+
+    void gather(vector<Tank>& tanks, const Grid& grid, allignments team, const vector<int>& grid_tanks);
+    void apply_hit(vector<Tank>& tanks, int rocket, int candidate, int hit_value, vector<Rocket_hit>& hits);
+
+    //Rocket positions of this frame
+    vector<float> rocket_x;
+    vector<float> rocket_y;
+
+    //Bin (grid * 2 + team) per checked rocket, -1 for rockets that crossed a grid border or are off the map
+    vector<int> rocket_bins;
+    //Start of every bin in binned_rockets
+    vector<int> bin_start;
+    vector<int> binned_rockets;
+    vector<int> crossing_rockets;
+
+    //Per grid, the last crossing rocket that gathered its tanks, so grids along a path are only gathered once
+    vector<int> gathered_by;
+
+    Candidates candidates;
+};
+
+} // namespace Tmpl8
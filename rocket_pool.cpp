@@ -0,0 +1,185 @@
+#include "precomp.h"
+#include "rocket_pool.h"
+
+namespace Tmpl8
+{
+
+void Rocket_pool::add(vec2 position, vec2 speed, allignments allignment)
+{
+    origin_x.push_back(position.x);
+    origin_y.push_back(position.y);
+    speed_x.push_back(speed.x);
+    speed_y.push_back(speed.y);
+    launch_frame.push_back(current_frame);
+    this->allignment.push_back(allignment);
+    id.push_back(new_id((int)size() - 1));
+}
+
+void Rocket_pool::append(const Rocket_pool& other)
+{
+    origin_x.insert(origin_x.end(), other.origin_x.begin(), other.origin_x.end());
+    origin_y.insert(origin_y.end(), other.origin_y.begin(), other.origin_y.end());
+    speed_x.insert(speed_x.end(), other.speed_x.begin(), other.speed_x.end());
+    speed_y.insert(speed_y.end(), other.speed_y.begin(), other.speed_y.end());
+    allignment.insert(allignment.end(), other.allignment.begin(), other.allignment.end());
+
+    //Move the launch frames over to the frame counter of this pool
+    const int frame_offset = current_frame - other.current_frame;
+    for (int frame : other.launch_frame)
+    {
+        launch_frame.push_back(frame + frame_offset);
+        id.push_back(new_id((int)launch_frame.size() - 1));
+    }
+}
+
+void Rocket_pool::remove(size_t index)
+{
+    const size_t last = size() - 1;
+
+    free_id(id[index]);
+    index_of[id[last]] = (int)index;
+    id[index] = id[last];
+
+    origin_x[index] = origin_x[last];
+    origin_y[index] = origin_y[last];
+    speed_x[index] = speed_x[last];
+    speed_y[index] = speed_y[last];
+    launch_frame[index] = launch_frame[last];
+    allignment[index] = allignment[last];
+
+    origin_x.pop_back();
+    origin_y.pop_back();
+    speed_x.pop_back();
+    speed_y.pop_back();
+    launch_frame.pop_back();
+    allignment.pop_back();
+    id.pop_back();
+}
+
+int Rocket_pool::new_id(int index)
+{
+    if (free_ids.empty())
+    {
+        index_of.push_back(index);
+        return (int)index_of.size() - 1;
+    }
+
+    const int rocket_id = free_ids.back();
+    free_ids.pop_back();
+    index_of[rocket_id] = index;
+    return rocket_id;
+}
+
+void Rocket_pool::free_id(int rocket_id)
+{
+    index_of[rocket_id] = -1;
+    free_ids.push_back(rocket_id);
+}
+
+//Position = origin + speed * age for all rockets
+//8 rockets per step with AVX2, otherwise 4 per step with SSE2 (always there on x64), the rest one by one
+void Rocket_pool::get_positions(vector<float>& x, vector<float>& y) const
+{
+    const size_t count = size();
+    x.resize(count);
+    y.resize(count);
+    size_t i = 0;
+
+#ifdef __AVX2__
+    const __m256i frame8 = _mm256_set1_epi32(current_frame);
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 age8 = _mm256_cvtepi32_ps(_mm256_sub_epi32(frame8, _mm256_loadu_si256((const __m256i*)&launch_frame[i])));
+        _mm256_storeu_ps(&x[i], _mm256_add_ps(_mm256_loadu_ps(&origin_x[i]), _mm256_mul_ps(_mm256_loadu_ps(&speed_x[i]), age8)));
+        _mm256_storeu_ps(&y[i], _mm256_add_ps(_mm256_loadu_ps(&origin_y[i]), _mm256_mul_ps(_mm256_loadu_ps(&speed_y[i]), age8)));
+    }
+#endif
+
+    const __m128i frame4 = _mm_set1_epi32(current_frame);
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 age4 = _mm_cvtepi32_ps(_mm_sub_epi32(frame4, _mm_loadu_si128((const __m128i*)&launch_frame[i])));
+        _mm_storeu_ps(&x[i], _mm_add_ps(_mm_loadu_ps(&origin_x[i]), _mm_mul_ps(_mm_loadu_ps(&speed_x[i]), age4)));
+        _mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&origin_y[i]), _mm_mul_ps(_mm_loadu_ps(&speed_y[i]), age4)));
+    }
+
+    for (; i < count; i++)
+    {
+        const float age = (float)(current_frame - launch_frame[i]);
+        x[i] = origin_x[i] + speed_x[i] * age;
+        y[i] = origin_y[i] + speed_y[i] * age;
+    }
+}
+
+size_t Rocket_pool::cull(vec2 bounds_min, vec2 bounds_max, float margin, int max_age)
+{
+    const vec2 reach_min = bounds_min - vec2(margin, margin);
+    const vec2 reach_max = bounds_max + vec2(margin, margin);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < size(); i++)
+    {
+        //Rockets fly in a straight line, so once outside on an axis while moving away on it they never come back
+        const vec2 start = get_position(i) - get_speed(i);
+        const bool left_map = (start.x < reach_min.x && speed_x[i] <= 0) || (start.x > reach_max.x && speed_x[i] >= 0) ||
+                              (start.y < reach_min.y && speed_y[i] <= 0) || (start.y > reach_max.y && speed_y[i] >= 0);
+        const bool expired = max_age > 0 && get_age(i) > max_age;
+
+        if (left_map || expired)
+        {
+            free_id(id[i]);
+            continue;
+        }
+
+        if (kept != i)
+        {
+            origin_x[kept] = origin_x[i];
+            origin_y[kept] = origin_y[i];
+            speed_x[kept] = speed_x[i];
+            speed_y[kept] = speed_y[i];
+            launch_frame[kept] = launch_frame[i];
+            allignment[kept] = allignment[i];
+            id[kept] = id[i];
+            index_of[id[kept]] = (int)kept;
+        }
+        kept++;
+    }
+
+    const size_t removed = size() - kept;
+    origin_x.resize(kept);
+    origin_y.resize(kept);
+    speed_x.resize(kept);
+    speed_y.resize(kept);
+    launch_frame.resize(kept);
+    allignment.resize(kept);
+    id.resize(kept);
+
+    culled_count += removed;
+    return removed;
+}
+
+//Draw the sprites with the facing based on the movement direction of every rocket
+//The animation frame follows from the age, it loops over 9 frames
+void Rocket_pool::draw(Render_buffer& buffer) const
+{
+    for (size_t i = 0; i < size(); i++)
+    {
+        const float sx = speed_x[i];
+        const float sy = speed_y[i];
+        const vec2 position = get_position(i);
+        const int frame = get_age(i) % 9;
+
+        const Sprite* sprite = sprites[allignment[i]];
+        const int sprite_frame = ((abs(sx) > abs(sy)) ? ((sx < 0) ? 3 : 0) : ((sy < 0) ? 9 : 6)) + (frame / 3);
+        buffer.push(ROCKET_LAYER, sprite, sprite_frame, (int)position.x - 12 + HEALTHBAR_OFFSET, (int)position.y - 12);
+    }
+}
+
+bool Rocket_pool::intersects(size_t index, vec2 position_other, float radius_other) const
+{
+    //Note: Uses squared lengths to remove expensive square roots
+    const float distance_sqr = (position_other - get_position(index)).sqr_length();
+    return distance_sqr <= ((collision_radius + radius_other) * (collision_radius + radius_other));
+}
+
+} // namespace Tmpl8
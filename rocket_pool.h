@@ -0,0 +1,75 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//All rockets in structure of arrays layout. Rockets fly in a straight line at a constant speed, so a rocket only
+//stores where and when it was launched and its position is computed when asked for: advancing the pool is a
+//single counter increment, and the passes that need all positions evaluate them 8 rockets at a time
+//Rockets are removed by moving the last rocket into their slot, so the order of the rockets changes on removal
+class Rocket_pool
+{
+  public:
+    void set_collision_radius(float radius) { collision_radius = radius; }
+    void set_sprite(allignments allignment, Sprite* sprite) { sprites[allignment] = sprite; }
+
+    //Launch a rocket from position at the current frame of the pool
+    void add(vec2 position, vec2 speed, allignments allignment);
+    //Append all rockets of other, keeps their order and their age
+    void append(const Rocket_pool& other);
+    //Swap and pop, the last rocket takes the place of the removed one
+    void remove(size_t index);
+
+    size_t size() const { return origin_x.size(); }
+
+    //Move all rockets one frame further along their path
+    void tick() { current_frame++; }
+
+    //Remove the rockets that can't hit anything anymore: older than max_age frames (0 for no limit), or already
+    //outside of the bounds grown by margin at the start of this frame and moving further away
+    //Compacts in a single pass that keeps the order of the remaining rockets, returns how many were removed
+    size_t cull(vec2 bounds_min, vec2 bounds_max, float margin, int max_age);
+    size_t get_culled_count() const { return culled_count; }
+    void draw(Render_buffer& buffer) const;
+
+    vec2 get_position(size_t index) const { return vec2(origin_x[index], origin_y[index]) + get_speed(index) * (float)get_age(index); }
+    vec2 get_speed(size_t index) const { return vec2(speed_x[index], speed_y[index]); }
+    int get_age(size_t index) const { return current_frame - launch_frame[index]; }
+    allignments get_allignment(size_t index) const { return allignment[index]; }
+    float get_collision_radius() const { return collision_radius; }
+
+    //Rockets move around in the arrays, the id of a rocket stays the same. Ids of removed rockets get reused
+    int get_id(size_t index) const { return id[index]; }
+    //Index of the rocket with the id, -1 if it was removed
+    int find(int rocket_id) const { return index_of[rocket_id]; }
+
+    //Positions of all rockets at the current frame
+    void get_positions(vector<float>& x, vector<float>& y) const;
+
+    //Does the given circle collide with the collision circle of the rocket?
+    bool intersects(size_t index, vec2 position_other, float radius_other) const;
+
+  private:
+    vector<float> origin_x;
+    vector<float> origin_y;
+    vector<float> speed_x;
+    vector<float> speed_y;
+    vector<int> launch_frame;
+    vector<allignments> allignment;
+    vector<int> id;
+
+    int new_id(int index);
+    void free_id(int rocket_id);
+
+    vector<int> index_of;
+    vector<int> free_ids;
+
+    //Frame counter of this pool, a rocket is current_frame - launch_frame frames old
+    int current_frame = 0;
+
+    float collision_radius = 0.f;
+    size_t culled_count = 0;
+    const Sprite* sprites[2] = {nullptr, nullptr};
+};
+
+} // namespace Tmpl8
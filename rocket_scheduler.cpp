@@ -0,0 +1,80 @@
+#include "precomp.h"
+#include "rocket_scheduler.h"
+
+namespace Tmpl8
+{
+
+void Rocket_scheduler::schedule(int rocket_id, long long frame)
+{
+    if ((size_t)rocket_id >= next_check.size()) next_check.resize(rocket_id + 1, -1);
+
+    next_check[rocket_id] = frame;
+    rechecks.schedule(rocket_id, frame);
+}
+
+void Rocket_scheduler::collect_due(const Rocket_pool& rockets, long long frame, vector<int>& due)
+{
+    due_ids.clear();
+    rechecks.advance(frame, due_ids);
+
+    //Only the entry of the live check counts, entries left behind by an earlier owner of the id are dropped
+    //Taking the check clears it, so an id that is due twice on this frame is only collected once
+    due.clear();
+    for (int rocket_id : due_ids)
+    {
+        long long& check = next_check[rocket_id];
+        if (check < 0 || check > frame) continue;
+        check = -1;
+
+        const int index = rockets.find(rocket_id);
+        if (index >= 0) due.push_back(index);
+    }
+    std::sort(due.begin(), due.end());
+
+    due_ids.clear();
+    for (int index : due)
+    {
+        due_ids.push_back(rockets.get_id(index));
+    }
+}
+
+void Rocket_scheduler::reschedule(const Rocket_pool& rockets, long long frame, const Distance_field& distance_field, int grid_size, float tank_radius)
+{
+    const float map_width = (float)(distance_field.get_width() * grid_size);
+    const float map_height = (float)(distance_field.get_height() * grid_size);
+    const float grid_diagonal = (float)grid_size * sqrtf(2.f);
+    const float reach = rockets.get_collision_radius() + tank_radius + slack;
+
+    for (int rocket_id : due_ids)
+    {
+        const int index = rockets.find(rocket_id);
+        if (index < 0) continue;
+
+        const vec2 position = rockets.get_position(index);
+        const int grid_x = (int)std::floor(position.x / grid_size);
+        const int grid_y = (int)std::floor(position.y / grid_size);
+
+        float distance;
+        if (grid_x >= 0 && grid_y >= 0 && grid_x < (int)distance_field.get_width() && grid_y < (int)distance_field.get_height())
+        {
+            const size_t grid_index = grid_y * distance_field.get_width() + grid_x;
+            distance = distance_field.grid_distance(enemy_of(rockets.get_allignment(index)), grid_index) * grid_size - grid_diagonal;
+        }
+        else
+        {
+            //Tanks in a grid are on the map, so the distance to the map is a bound too
+            const float dx = std::max({0.f, -position.x, position.x - map_width});
+            const float dy = std::max({0.f, -position.y, position.y - map_height});
+            distance = sqrtf(dx * dx + dy * dy);
+        }
+
+        const float closing_speed = rockets.get_speed(index).length() + tank_step;
+        const float frames = (distance - reach) / closing_speed;
+
+        int delay = 1;
+        if (frames > 1.f) delay = (frames >= (float)max_delay) ? max_delay : (int)frames;
+        schedule(rocket_id, frame + delay);
+    }
+}
+
+} // namespace Tmpl8
@@ -0,0 +1,46 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//Skips the hit checks of rockets that can't reach an enemy tank yet
+//After a check, the distance to the closest enemy grid (from the distance field) minus a grid diagonal bounds the
+//distance to the closest enemy tank. Rocket and tanks close in by at most rocket speed + tank_step per frame,
+//so the rocket isn't checked again until the frame where that gap could first be closed
+//Rechecks are kept in a timer wheel keyed on frame, by rocket id. Ids of removed rockets get reused while their old
+//entries are still in the wheel, so every id also remembers the frame of its one live check and other entries are
+//dropped when they come up
+class Rocket_scheduler
+{
+  public:
+    //tank_step is the furthest a tank moves in a frame, slack covers tanks that move several frames at once (lod)
+    void set_limits(float tank_step, float slack)
+    {
+        this->tank_step = tank_step;
+        this->slack = slack;
+    }
+
+    //Check the rocket on the given frame, new rockets are scheduled on the frame they are launched
+    void schedule(int rocket_id, long long frame);
+
+    //Indices (ascending) of the rockets to check on this frame
+    void collect_due(const Rocket_pool& rockets, long long frame, vector<int>& due);
+
+    //Schedule the next check of the rockets collected this frame that are still flying
+    void reschedule(const Rocket_pool& rockets, long long frame, const Distance_field& distance_field, int grid_size, float tank_radius);
+
+  private:
+    //Don't wait longer than this, so rockets that turn towards new tanks are picked up again
+    static constexpr int max_delay = 250;
+
+    Timer_wheel rechecks;
+    vector<int> due_ids;
+
+    //Frame of the pending check per rocket id, -1 when none is pending
+    vector<long long> next_check;
+
+    float tank_step = 0.f;
+    float slack = 0.f;
+};
+
+} // namespace Tmpl8
@@ -4,16 +4,9 @@
 namespace Tmpl8
 {
 
-void Smoke::tick()
+void Smoke::draw(Render_buffer& buffer, long long frame) const
 {
-    if (++current_frame == 60) current_frame = 0;
-}
-
-void Smoke::draw(Surface* screen)
-{
-    smoke_sprite.set_frame(current_frame / 15);
-
-    smoke_sprite.draw(screen, (int)position.x + HEALTHBAR_OFFSET, (int)position.y);
+    buffer.push(SMOKE_LAYER, smoke_sprite, get_animation(SMOKE_ANIMATION).sprite_frame(start_frame, frame), (int)position.x + HEALTHBAR_OFFSET, (int)position.y);
 }
 
 } // namespace Tmpl8
\ No newline at end of file
@@ -5,14 +5,13 @@ namespace Tmpl8
 class Smoke
 {
   public:
-    Smoke(Sprite& smoke_sprite, vec2 position) : current_frame(0), smoke_sprite(smoke_sprite), position(position) {}
+    Smoke(Sprite* smoke_sprite, vec2 position, long long start_frame) : start_frame(start_frame), smoke_sprite(smoke_sprite), position(position) {}
 
-    void tick();
-    void draw(Surface* screen);
+    void draw(Render_buffer& buffer, long long frame) const;
 
     vec2 position;
 
-    int current_frame;
-    Sprite& smoke_sprite;
+    long long start_frame;
+    const Sprite* smoke_sprite;
 };
 } // namespace Tmpl8
\ No newline at end of file
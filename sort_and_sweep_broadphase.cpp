@@ -0,0 +1,45 @@
+#include "precomp.h"
+#include "sort_and_sweep_broadphase.h"
+
+namespace Tmpl8
+{
+
+void Sort_and_sweep_broadphase::build(const vector<Tank>& tanks, ThreadPool&, size_t)
+{
+    sorted.clear();
+    max_radius = 0.f;
+
+    for (size_t i = 0; i < tanks.size(); i++)
+    {
+        const Tank& t = tanks[i];
+        if (t.active == false) continue;
+
+        sorted.push_back({t.position.x, (int)i});
+        max_radius = std::max(max_radius, t.collision_radius);
+    }
+
+    std::sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) { return (a.x < b.x) || (a.x == b.x && a.tank < b.tank); });
+}
+
+void Sort_and_sweep_broadphase::collide(vector<Tank>& tanks, ThreadPool& pool, size_t thread_count)
+{
+    run_partitioned(pool, Grid_partitioner::split_evenly(sorted.size(), thread_count), [this, &tanks](Grid_range range)
+    {
+        for (size_t i = range.begin; i < range.end; i++)
+        {
+            Tank& t = tanks[sorted[i].tank];
+            const float reach = t.collision_radius + max_radius;
+
+            for (size_t j = i; j-- > 0 && sorted[i].x - sorted[j].x < reach;)
+            {
+                push_apart(t, tanks[sorted[j].tank]);
+            }
+            for (size_t j = i + 1; j < sorted.size() && sorted[j].x - sorted[i].x < reach; j++)
+            {
+                push_apart(t, tanks[sorted[j].tank]);
+            }
+        }
+    });
+}
+
+} // namespace Tmpl8
@@ -0,0 +1,28 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//Keeps the active tanks sorted on x, a tank only has to look at the tanks next to it in that order
+//until the x distance alone rules out an overlap. Doesn't care how large the map is or how tanks clump on y
+class Sort_and_sweep_broadphase : public Broadphase
+{
+  public:
+    const char* get_name() const override { return "sort and sweep"; }
+
+    void build(const vector<Tank>& tanks, ThreadPool& pool, size_t thread_count) override;
+    void collide(vector<Tank>& tanks, ThreadPool& pool, size_t thread_count) override;
+
+  private:
+    struct Entry
+    {
+        float x;
+        int tank;
+    };
+
+    //Active tanks sorted on x, ties on index so the order is deterministic
+    vector<Entry> sorted;
+    float max_radius = 0.f;
+};
+
+} // namespace Tmpl8
@@ -373,6 +373,11 @@ Sprite::~Sprite()
 }
 
 void Sprite::draw(Surface* a_Target, int a_X, int a_Y)
+{
+    draw(a_Target, a_X, a_Y, m_CurrentFrame);
+}
+
+void Sprite::draw(Surface* a_Target, int a_X, int a_Y, unsigned int a_Frame) const
 {
     //If out of screen skip
     if ((a_X < -m_Width) || (a_X > (a_Target->get_width() + m_Width))) return;
@@ -383,7 +388,7 @@ void Sprite::draw(Surface* a_Target, int a_X, int a_Y)
     int y1 = a_Y, y2 = a_Y + m_Height;
 
     //Image start
-    Pixel* src = get_buffer() + m_CurrentFrame * m_Width;
+    Pixel* src = m_Surface->get_buffer() + a_Frame * m_Width;
     //Set start x to within screen
     if (x1 < 0)
     {
@@ -409,7 +414,7 @@ void Sprite::draw(Surface* a_Target, int a_X, int a_Y)
         for (int y = 0; y < height; y++)
         {
             const int line = y + (y1 - a_Y);
-            const int lsx = m_Start[m_CurrentFrame][line] + a_X;
+            const int lsx = m_Start[a_Frame][line] + a_X;
             if (m_Flags & FLARE)
             {
                 xs = (lsx > x1) ? lsx - x1 : 0;
@@ -115,6 +115,8 @@ class Sprite
     ~Sprite();
     // Methods
     void draw(Surface* a_Target, int a_X, int a_Y);
+    // Draws the given frame, leaves the sprite untouched so a shared sprite can be drawn from several threads
+    void draw(Surface* a_Target, int a_X, int a_Y, unsigned int a_Frame) const;
     void draw_scaled(int a_X, int a_Y, int a_Width, int a_Height, Surface* a_Target);
     void set_flags(unsigned int a_Flags) { m_Flags = a_Flags; }
     void set_frame(unsigned int a_Index) { m_CurrentFrame = a_Index; }
@@ -22,11 +22,11 @@ Tank::Tank(
       collision_radius(collision_radius),
       max_speed(max_speed),
       force(0, 0),
-      reload_time(1),
-      reloaded(false),
       speed(0),
+      next_position(pos_x, pos_y),
+      next_speed(0),
       active(true),
-      current_frame(0),
+      sleeping(false),
       tank_sprite(tank_sprite),
       smoke_sprite(smoke_sprite)
 {
@@ -36,7 +36,7 @@ Tank::~Tank()
 {
 }
 
-void Tank::tick(Terrain& terrain)
+void Tank::tick(Terrain& terrain, int frames)
 {
     vec2 direction = vec2(0, 0);
 
@@ -45,24 +45,28 @@ void Tank::tick(Terrain& terrain)
         direction = (target - position).normalized();
     }
 
-    //Update using accumulated force
-    speed = direction + force;
-    position += speed * max_speed * 0.5f;
-
-    //Update reload time
-    if (--reload_time <= 0.0f)
+    //Update using accumulated force, the force was collected over all frames since the last tick
+    //Pushes are capped, so a tank in a clump can't be shoved further per frame than its own speed allows
+    vec2 push = force / (float)frames;
+    const float push_sqr = push.sqr_length();
+    if (push_sqr > max_push_speed * max_push_speed) push = push * (max_push_speed / sqrtf(push_sqr));
+    next_speed = direction + push;
+    next_position = position + next_speed * max_speed * 0.5f * (float)frames;
+
+    //Parked at the final target without being pushed around, stop ticking until woken up
+    const float step = max_speed * 0.5f * (float)frames;
+    if (current_route.empty() && force == vec2(0.f, 0.f) && (target - next_position).sqr_length() <= step * step)
     {
-        reloaded = true;
+        next_speed = vec2(0.f, 0.f);
+        sleeping = true;
     }
 
     force = vec2(0.f, 0.f);
 
-    if (++current_frame > 8) current_frame = 0;
-
     //Target reached?
     if (current_route.size() > 0)
     {
-        if (std::abs(position.x - target.x) < 8.f && std::abs(position.y - target.y) < 8.f)
+        if (std::abs(next_position.x - target.x) < 8.f && std::abs(next_position.y - target.y) < 8.f)
         {
             target = current_route.at(0);
             current_route.erase(current_route.begin());
@@ -70,6 +74,13 @@ void Tank::tick(Terrain& terrain)
     }
 }
 
+//Make the next frame state the current one
+void Tank::swap_buffers()
+{
+    position = next_position;
+    speed = next_speed;
+}
+
 void Tank::set_route(const std::vector<vec2>& route)
 {
     if (route.size() > 0)
@@ -84,13 +95,6 @@ void Tank::set_route(const std::vector<vec2>& route)
     }
 }
 
-//Start reloading timer
-void Tank::reload_rocket()
-{
-    reloaded = false;
-    reload_time = 200.0f;
-}
-
 void Tank::deactivate()
 {
     active = false;
@@ -99,6 +103,7 @@ void Tank::deactivate()
 //Remove health
 bool Tank::hit(int hit_value)
 {
+    wake_up();
     health -= hit_value;
 
     if (health <= 0)
@@ -111,11 +116,23 @@ bool Tank::hit(int hit_value)
 }
 
 //Draw the sprite with the facing based on this tanks movement direction
-void Tank::draw(Surface* screen)
+void Tank::draw(Render_buffer& buffer, long long frame) const
+{
+    make_decal(frame).draw(buffer, TANK_LAYER);
+}
+
+//Freeze the current sprite of this tank
+Tank_decal Tank::make_decal(long long frame) const
 {
     vec2 direction = (target - position).normalized();
-    tank_sprite->set_frame(((abs(direction.x) > abs(direction.y)) ? ((direction.x < 0) ? 3 : 0) : ((direction.y < 0) ? 9 : 6)) + (current_frame / 3));
-    tank_sprite->draw(screen, (int)position.x - 7 + HEALTHBAR_OFFSET, (int)position.y - 9);
+    const int tracks_frame = sleeping ? 0 : get_animation(TANK_TRACKS_ANIMATION).sprite_frame(0, frame);
+    const int sprite_frame = ((abs(direction.x) > abs(direction.y)) ? ((direction.x < 0) ? 3 : 0) : ((direction.y < 0) ? 9 : 6)) + tracks_frame;
+    return Tank_decal{position, tank_sprite, sprite_frame};
+}
+
+void Tank_decal::draw(Render_buffer& buffer, Render_layer layer) const
+{
+    buffer.push(layer, sprite, frame, (int)position.x - 7 + HEALTHBAR_OFFSET, (int)position.y - 9);
 }
 
 int Tank::compare_health(const Tank& other) const
@@ -126,6 +143,7 @@ int Tank::compare_health(const Tank& other) const
 //Add some force in a given direction
 void Tank::push(vec2 direction, float magnitude)
 {
+    wake_up();
     force += direction * magnitude;
 }
 
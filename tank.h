@@ -10,35 +10,69 @@ enum allignments
     RED
 };
 
+constexpr allignments enemy_of(allignments allignment) { return (allignment == BLUE) ? RED : BLUE; }
+
+//What remains on screen of a destroyed tank, it takes no part in the simulation anymore
+struct Tank_decal
+{
+    vec2 position;
+    const Sprite* sprite;
+    int frame;
+
+    void draw(Render_buffer& buffer, Render_layer layer) const;
+};
+
 class Tank
 {
   public:
     Tank(float pos_x, float pos_y, allignments allignment, Sprite* tank_sprite, Sprite* smoke_sprite, float tar_x, float tar_y, float collision_radius, int health, float max_speed);
 
+    //Largest speed pushes can add, relative to the unit length movement direction. A tank moves at most
+    //(1 + max_push_speed) * max_speed * 0.5 per frame
+    static constexpr float max_push_speed = 1.f;
+
     ~Tank();
 
-    void tick(Terrain& terrain);
+    //The destructor would otherwise suppress the moves, reordering the tanks moves their routes instead of copying
+    Tank(const Tank&) = default;
+    Tank(Tank&&) = default;
+    Tank& operator=(const Tank&) = default;
+    Tank& operator=(Tank&&) = default;
+
+    //Reads the current state and only writes the next frame state, commit it with swap_buffers
+    //frames > 1 covers that many frames in one tick, for tanks updated at a reduced rate
+    void tick(Terrain& terrain, int frames = 1);
+    void swap_buffers();
 
     vec2 get_position() const { return position; };
     float get_collision_radius() const { return collision_radius; };
-    bool rocket_reloaded() const { return reloaded; };
 
     void set_route(const std::vector<vec2>& route);
-    void reload_rocket();
 
     void deactivate();
     bool hit(int hit_value);
 
-    void draw(Surface* screen);
+    //A tank that parked at its final target sleeps until it gets pushed or hit
+    bool is_sleeping() const { return sleeping; }
+    void wake_up() { sleeping = false; }
+
+    //The tracks animate while the tank is awake, from the game frame instead of a per tank counter
+    void draw(Render_buffer& buffer, long long frame) const;
+    Tank_decal make_decal(long long frame) const;
 
     int compare_health(const Tank& other) const;
 
     void push(vec2 direction, float magnitude);
 
+    //Current frame state, read only during the update
     vec2 position;
     vec2 speed;
     vec2 target;
 
+    //Next frame state, written by tick
+    vec2 next_position;
+    vec2 next_speed;
+
     vector<vec2> current_route;
 
     int health;
@@ -47,14 +81,12 @@ class Tank
     vec2 force;
 
     float max_speed;
-    float reload_time;
 
-    bool reloaded;
     bool active;
+    bool sleeping;
 
     allignments allignment;
 
-    int current_frame;
     Sprite* tank_sprite;
     Sprite* smoke_sprite;
 
@@ -43,6 +43,7 @@ namespace Tmpl8
         //Custom add
         size_t GetWidth() const { return terrain_width; }
         size_t GetHeight() const { return terrain_height; }
+        vec2 GetWorldSize() const { return vec2((float)(terrain_width * sprite_size), (float)(terrain_height * sprite_size)); }
 
 
     private:
@@ -0,0 +1,77 @@
+#include "precomp.h"
+#include "timer_wheel.h"
+
+namespace Tmpl8
+{
+
+Timer_wheel::Timer_wheel() : near(near_slots), far(far_slots)
+{
+}
+
+void Timer_wheel::schedule(int id, long long frame)
+{
+    insert({id, frame});
+    scheduled++;
+}
+
+void Timer_wheel::advance(long long frame, vector<int>& due)
+{
+    for (; current_frame <= frame; current_frame++)
+    {
+        const long long block = current_frame >> near_bits;
+
+        //Entering a new block of frames, move its entries down to the per frame slots
+        if ((current_frame & (near_slots - 1)) == 0)
+        {
+            //All far slots are used up once, entries waiting in the overflow may fit now
+            if ((block & (far_slots - 1)) == 0)
+            {
+                vector<Entry> waiting;
+                waiting.swap(overflow);
+                cascade(waiting);
+            }
+            cascade(far[block & (far_slots - 1)]);
+        }
+
+        vector<Entry>& slot = near[current_frame & (near_slots - 1)];
+        for (const Entry& entry : slot)
+        {
+            due.push_back(entry.id);
+        }
+        scheduled -= slot.size();
+        slot.clear();
+    }
+}
+
+void Timer_wheel::insert(const Entry& entry)
+{
+    //Frames that already passed fire as soon as possible
+    const long long frame = std::max(entry.frame, current_frame);
+    const long long block = frame >> near_bits;
+    const long long current_block = current_frame >> near_bits;
+
+    if (block == current_block)
+    {
+        near[frame & (near_slots - 1)].push_back({entry.id, frame});
+    }
+    else if (block - current_block < far_slots)
+    {
+        far[block & (far_slots - 1)].push_back({entry.id, frame});
+    }
+    else
+    {
+        overflow.push_back({entry.id, frame});
+    }
+}
+
+void Timer_wheel::cascade(vector<Entry>& slot)
+{
+    vector<Entry> entries;
+    entries.swap(slot);
+    for (const Entry& entry : entries)
+    {
+        insert(entry);
+    }
+}
+
+} // namespace Tmpl8
@@ -0,0 +1,47 @@
+#pragma once
+
+namespace Tmpl8
+{
+
+//Hierarchical timer wheel that hands back the ids that are due on a frame
+//Level 0 has a slot per frame for the next 256 frames, level 1 a slot per 256 frames for the 64 blocks after that,
+//anything further away waits in an overflow list. Entries move down a level when their block comes up,
+//so advancing costs the number of due entries instead of the number of scheduled ones
+class Timer_wheel
+{
+  public:
+    Timer_wheel();
+
+    //Schedule id for the given frame, frames in the past fire on the next advance
+    void schedule(int id, long long frame);
+
+    //Append the ids due up to and including frame to due, in a deterministic order
+    void advance(long long frame, vector<int>& due);
+
+    size_t size() const { return scheduled; }
+
+  private:
+    static constexpr int near_bits = 8;
+    static constexpr int far_bits = 6;
+    static constexpr long long near_slots = 1ll << near_bits;
+    static constexpr long long far_slots = 1ll << far_bits;
+
+    struct Entry
+    {
+        int id;
+        long long frame;
+    };
+
+    void insert(const Entry& entry);
+    void cascade(vector<Entry>& slot);
+
+    //Next frame that advance will process
+    long long current_frame = 0;
+    size_t scheduled = 0;
+
+    vector<vector<Entry>> near;
+    vector<vector<Entry>> far;
+    vector<Entry> overflow;
+};
+
+} // namespace Tmpl8
@@ -0,0 +1,29 @@
+#include "precomp.h"
+#include "uniform_grid_broadphase.h"
+
+namespace Tmpl8
+{
+
+//Every grid only pushes its own tanks, so the grids are split over the threads.
+//A grid costs tanks^2 collision checks, so partition on that instead of on grid count
+void Uniform_grid_broadphase::collide(vector<Tank>& tanks, ThreadPool& pool, size_t thread_count)
+{
+    const vector<Grid_range> ranges = Grid_partitioner::partition(grids, thread_count, [](size_t tank_count) { return tank_count * tank_count; });
+    run_partitioned(pool, ranges, [this, &tanks](Grid_range range)
+    {
+        occupancy.for_each_occupied(range.begin, range.end, [this, &tanks](size_t i)
+        {
+            const Grid& g = grids[i];
+            for (Tank& t : g.GetTanks(tanks, grid_tanks))
+            {
+                for (Tank& ot : g.GetTanks(tanks, grid_tanks))
+                {
+                    if (&t == &ot) continue;
+                    push_apart(t, ot);
+                }
+            }
+        });
+    });
+}
+
+} // namespace Tmpl8
@@ -0,0 +1,27 @@
+#pragma once
+
+class Grid;
+
+namespace Tmpl8
+{
+
+//Uses the grids the game rebins every frame, so build has nothing left to do
+//Tanks only collide with the tanks in their own grid
+class Uniform_grid_broadphase : public Broadphase
+{
+  public:
+    Uniform_grid_broadphase(const vector<Grid>& grids, const vector<int>& grid_tanks, const Occupancy_bitmap& occupancy)
+        : grids(grids), grid_tanks(grid_tanks), occupancy(occupancy) {}
+
+    const char* get_name() const override { return "uniform grid"; }
+
+    void build(const vector<Tank>&, ThreadPool&, size_t) override {}
+    void collide(vector<Tank>& tanks, ThreadPool& pool, size_t thread_count) override;
+
+  private:
+    const vector<Grid>& grids;
+    const vector<int>& grid_tanks;
+    const Occupancy_bitmap& occupancy;
+};
+
+} // namespace Tmpl8